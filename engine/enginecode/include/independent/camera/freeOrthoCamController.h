@@ -23,6 +23,7 @@ namespace Engine
 		virtual inline Camera& getCamera() override { return m_camera; }	//!< get the camera.
 		virtual void onUpdate(float time) override;							//!< on update function.
 		virtual void onEvent(Event& event) override;						//!< on event function.	//TO-DO: change to do just resizing - will need to change projectionmatrix.	
+		void getViewBounds(glm::vec2& min, glm::vec2& max) const;			//!< world space rectangle the camera can see; bounds the rotated view if the camera is rotated.
 	
 	private:
 		glm::vec3 m_position = { 0.0f, 0.0f, 0.0f };						//!< vec3 to take position of camera.
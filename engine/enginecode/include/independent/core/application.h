@@ -3,6 +3,7 @@
 
 #include "systems/log.h"
 #include "systems/randomNumberGenerator.h"
+#include "systems/jobSystem.h"
 
 #include "events/eventHeaders.h"
 
@@ -21,6 +22,7 @@ namespace Engine {
 		Application();	//!< Constructor
 		std::shared_ptr<Log> m_logSystem;						//!< the log system.
 		std::shared_ptr<RandomNumberGenerator> m_ranNumSytem;	//!< the random number generator system.
+		std::shared_ptr<JobSystem> m_jobSystem;					//!< the job system, worker threads for work that can be split up.
 		std::shared_ptr<System> m_windowsSystem;				//!< the windows system.
 													
 		/* ***NOTE*** - IF MORE THAN ONE WINDOW. Should have a list or vector containing all windows.
@@ -7,6 +7,7 @@
 #include "events/userEvents.h"
 
 #include "rendering/subTexture.h"
+#include "rendering/spriteAtlas.h"
 #include "rendering/indexBuffer.h"
 #include "rendering/vertexBuffer.h"
 #include "rendering/vertexArray.h"
@@ -14,10 +15,20 @@
 #include "rendering/textures.h"
 #include "rendering/bufferLayout.h"
 #include "rendering/uniformBuffer.h"
+#include "rendering/storageBuffer.h"
 #include "rendering/textureUnitManager.h"
+#include "rendering/boundingBox.h"
+#include "rendering/shaderPreprocessor.h"
+#include "rendering/blockLayout.h"
 
 #include "renderer/renderer3D.h"
 #include "renderer/renderer2D.h"
+#include "renderer/tilemap.h"
+#include "renderer/geometryPool.h"
+#include "renderer/meshSimplifier.h"
+#include "renderer/frustum.h"
+#include "renderer/aabbTree.h"
+#include "renderer/shaderVariants.h"
 
 #include "shaders/FCVertex.h"
 
@@ -0,0 +1,61 @@
+/** \file aabbTree.h */
+#pragma once
+
+#include "renderer/frustum.h"
+#include <vector>
+
+namespace Engine
+{
+	/* \struct AABBTreeQueryStats
+	*  \brief Counters for a frustum query of an AABB tree.
+	*/
+	struct AABBTreeQueryStats
+	{
+		uint32_t nodesTested = 0;	//!< nodes tested against the planes.
+		uint32_t visible = 0;		//!< leaves found inside or crossing the frustum.
+	};
+
+	/* \class AABBTree
+	*  \brief A dynamic bounding volume hierarchy. Leaves hold a fattened copy of their box, so an object that moves a little only needs its box checked;
+	*  it is taken out and put back only once it leaves the fat box, refitting just the branch it was in. Inserts pick the sibling that grows the
+	*  total surface area least, and branches are rotated to keep the tree balanced.
+	*/
+	class AABBTree
+	{
+	public:
+		constexpr static int32_t nullNode = -1;		//!< no node.
+
+		AABBTree(float margin = 0.1f);				//!< constructor; how much leaf boxes are fattened by on each side.
+		int32_t insert(const AABB& bounds, uint32_t userData);	//!< add a box; returns the proxy to update or remove it with.
+		void remove(int32_t proxy);					//!< take a box out.
+		bool update(int32_t proxy, const AABB& bounds);	//!< give a box its new bounds; true if it had to be reinserted.
+		void query(const Frustum& frustum, std::vector<uint32_t>& results, AABBTreeQueryStats& stats) const;	//!< append the user data of every leaf touching the frustum.
+		inline uint32_t getUserData(int32_t proxy) const { return m_nodes[proxy].userData; }	//!< accessor for a leaf's user data.
+		inline const AABB& getFatBounds(int32_t proxy) const { return m_nodes[proxy].bounds; }	//!< accessor for a leaf's fattened box.
+		inline int32_t getHeight() const { return m_root == nullNode ? 0 : m_nodes[m_root].height; }	//!< height of the tree, 0 for a leaf.
+	private:
+		struct Node
+		{
+			AABB bounds;				//!< box around everything below, fattened for leaves.
+			int32_t parent;				//!< parent node, or the next free node when free.
+			int32_t child1;				//!< first child, nullNode for leaves.
+			int32_t child2;				//!< second child.
+			int32_t height;				//!< 0 for leaves, -1 when free.
+			uint32_t userData;			//!< what the leaf stands for.
+			inline bool isLeaf() const { return child1 == nullNode; }	//!< whether it is a leaf.
+		};	//!< a node of the tree, kept in a flat array.
+
+		int32_t allocateNode();					//!< take a node from the free list, growing the array if it's empty.
+		void freeNode(int32_t node);			//!< give a node back.
+		void insertLeaf(int32_t leaf);			//!< link a leaf into the tree.
+		void removeLeaf(int32_t leaf);			//!< unlink a leaf from the tree.
+		void refit(int32_t node);				//!< rebalance and recompute boxes and heights from a node up to the root.
+		int32_t balance(int32_t a);				//!< rotate a node if one side is more than one taller; returns the node now in its place.
+		void collect(int32_t node, std::vector<uint32_t>& results) const;	//!< append every leaf below a node without testing.
+
+		std::vector<Node> m_nodes;				//!< every node, used or free.
+		int32_t m_root = nullNode;				//!< root node.
+		int32_t m_freeList = nullNode;			//!< first free node.
+		float m_margin;							//!< fattening on each side of a leaf's box.
+	};
+}
@@ -0,0 +1,31 @@
+/** \file frustum.h */
+#pragma once
+
+#include "rendering/boundingBox.h"
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	/* \enum FrustumTest
+	*  \brief Where a box is relative to a frustum.
+	*/
+	enum class FrustumTest { Outside, Intersecting, Inside };
+
+	/* \class Frustum
+	*  \brief The six planes of a camera's view volume, taken from its projection * view. Planes are kept as separate x, y, z and distance arrays
+	*  padded to eight, so a box is tested against four planes at a time with SSE.
+	*/
+	class Frustum
+	{
+	public:
+		Frustum();														//!< default constructor; everything is inside.
+		explicit Frustum(const glm::mat4& projectionView);				//!< constructor, extracting the planes (Gribb and Hartmann).
+		FrustumTest test(const AABB& box) const;						//!< classify a box against every plane.
+		inline glm::vec4 getPlane(uint32_t index) const { return glm::vec4(m_normalX[index], m_normalY[index], m_normalZ[index], m_distance[index]); }	//!< a plane, normal pointing in; left, right, bottom, top, near, far.
+	private:
+		alignas(16) float m_normalX[8];		//!< x of each plane's normal.
+		alignas(16) float m_normalY[8];		//!< y of each plane's normal.
+		alignas(16) float m_normalZ[8];		//!< z of each plane's normal.
+		alignas(16) float m_distance[8];	//!< distance of each plane; the last two are padding that everything is inside.
+	};
+}
@@ -0,0 +1,64 @@
+/** \file geometryPool.h */
+#pragma once
+
+#include "rendering/vertexArray.h"
+#include "renderer/rangeAllocator.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Engine
+{
+	/* \struct MeshLOD
+	*  \brief One level of detail of a mesh in a geometry pool; its own run of indices into the same vertices.
+	*/
+	struct MeshLOD
+	{
+		uint32_t firstIndex = 0;	//!< first index in the pool's index buffer.
+		uint32_t indexCount = 0;	//!< number of indices.
+		float screenSize = 0.0f;	//!< drawn once the mesh's bounding sphere is smaller than this on screen, as its radius over half the screen height.
+	};
+
+	/* \struct MeshRange
+	*  \brief Where a mesh sits in a geometry pool. Indices are relative to the mesh's first vertex, so they don't change with where it lands.
+	*/
+	struct MeshRange
+	{
+		constexpr static uint32_t maxLODs = 4;	//!< most levels of detail a mesh can have, including the original.
+
+		uint32_t firstVertex = 0;	//!< first vertex in the pool's vertex buffer.
+		uint32_t vertexCount = 0;	//!< number of vertices.
+		uint32_t firstIndex = 0;	//!< first index in the pool's index buffer.
+		uint32_t indexCount = 0;	//!< number of indices of the full detail mesh.
+		AABB bounds;				//!< bounds of the mesh's positions, for culling.
+		std::array<MeshLOD, maxLODs> lods;	//!< the full detail mesh then each simplified one, their indices back to back from firstIndex.
+		uint32_t lodCount = 0;		//!< levels of detail in use.
+		inline bool isValid() const { return indexCount > 0; }	//!< false if the mesh couldn't be added.
+	};
+
+	/* \class GeometryPool
+	*  \brief Big shared vertex and index buffers for every mesh of one vertex format, behind a single vertex array, so meshes from the same pool
+	*  can be drawn without changing vertex arrays and batched into one multi draw. Space is handed out first fit and merged back when freed.
+	*  A mesh can be added with levels of detail; each is simplified from the one before with MeshSimplifier and stored as more indices into the
+	*  same vertices, so the LODs cost index space only.
+	*/
+	class GeometryPool
+	{
+	public:
+		GeometryPool(const VertexBufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity);	//!< constructor; the layout every mesh uses and how many vertices and indices the pool holds.
+		MeshRange add(void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, uint32_t lodCount = 1);	//!< copy a mesh in with up to lodCount levels of detail, each about half the triangles of the last; the range is invalid if there isn't room.
+		void remove(const MeshRange& mesh);								//!< give a mesh's space back.
+		inline const std::shared_ptr<VertexArray>& getVertexArray() const { return m_VAO; }	//!< accessor for the vertex array every mesh is drawn with.
+		inline uint32_t getFreeVertices() const { return m_freeVertices.getFreeCount(); }	//!< accessor for vertices not in use (not necessarily in one run).
+		inline uint32_t getFreeIndices() const { return m_freeIndices.getFreeCount(); }	//!< accessor for indices not in use (not necessarily in one run).
+
+		constexpr static float lodScreenError = 0.002f;	//!< how far a LOD may have moved the surface once on screen, as a fraction of half the screen height; sets each LOD's screen size.
+	private:
+		uint32_t m_stride;							//!< bytes per vertex.
+		std::shared_ptr<VertexBuffer> m_VBO;		//!< every mesh's vertices.
+		std::shared_ptr<IndexBuffer> m_IBO;			//!< every mesh's indices.
+		std::shared_ptr<VertexArray> m_VAO;			//!< the one vertex array.
+		RangeAllocator m_freeVertices;				//!< free vertex ranges.
+		RangeAllocator m_freeIndices;				//!< free index ranges.
+	};
+}
@@ -0,0 +1,90 @@
+/** \file glyphAtlas.h */
+#pragma once
+
+#include "rendering/textures.h"
+#include "ft2build.h"
+#include "freetype/freetype.h"
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine
+{
+	/* \struct GlyphInfo
+	*  \brief Everything needed to draw a glyph that already sits in the atlas; all sizes in pixels.
+	*/
+	struct GlyphInfo
+	{
+		glm::vec2 UVStart = glm::vec2(0.0f);	//!< top left UV of the glyph within the atlas.
+		glm::vec2 UVEnd = glm::vec2(0.0f);		//!< bottom right UV of the glyph within the atlas.
+		glm::vec2 size = glm::vec2(0.0f);		//!< size of the glyph bitmap, 0 for glyphs with nothing to draw (spaces etc).
+		glm::vec2 bearing = glm::vec2(0.0f);	//!< offset from the pen position to the top left of the bitmap.
+		float advance = 0.0f;					//!< how far to move the pen on after this glyph.
+	};
+
+	/* \enum GlyphMode
+	*  \brief What the atlas stores for each glyph.
+	*/
+	enum class GlyphMode
+	{
+		Bitmap,		//!< coverage straight from freetype, only sharp at the size it was rasterised at.
+		SDF			//!< signed distance to the glyph edge, the edge can be rebuilt in the shader at any size.
+	};
+
+	/* \class GlyphAtlas
+	*  \brief A single texture holding every glyph rasterised so far, packed into shelves. Glyphs are rasterised and uploaded once, on first use or when prewarmed.
+	*/
+	class GlyphAtlas
+	{
+	public:
+		GlyphAtlas(uint32_t width, uint32_t height, uint32_t padding = 1, GlyphMode mode = GlyphMode::Bitmap, uint32_t spread = 8);	//!< constructor; size of the atlas texture in pixels, the gap left between glyphs, what is stored and, for SDF, how far in pixels the distance reaches past the edge.
+		const GlyphInfo& getGlyph(FT_Face face, uint32_t pixelSize, uint32_t codepoint);	//!< get a glyph, rasterising and uploading it only if it isn't in the atlas yet.
+		void prewarm(FT_Face face, uint32_t pixelSize, const std::vector<uint32_t>& codepoints);	//!< add a set of glyphs up front; distance fields are generated across the job system.
+		inline std::shared_ptr<Textures> getTexture() { return m_texture; }			//!< accessor for the atlas texture.
+		inline GlyphMode getMode() const { return m_mode; }							//!< accessor for what the atlas stores.
+		inline uint32_t getGlyphCount() const { return m_glyphs.size(); }			//!< accessor for the number of glyphs cached.
+	private:
+		struct GlyphKey
+		{
+			FT_Face face;			//!< the font face.
+			uint32_t pixelSize;		//!< pixel height the glyph was rasterised at.
+			uint32_t codepoint;		//!< the character.
+			bool operator==(const GlyphKey& other) const { return face == other.face && pixelSize == other.pixelSize && codepoint == other.codepoint; }	//!< equality for the map.
+		};	//!< what a glyph is cached against.
+
+		struct GlyphKeyHash
+		{
+			size_t operator()(const GlyphKey& key) const;	//!< hash the three parts of the key together.
+		};	//!< hash for the glyph map.
+
+		struct Shelf
+		{
+			uint32_t y;			//!< top of the shelf.
+			uint32_t height;	//!< height of the shelf, set by the first glyph placed on it.
+			uint32_t x;			//!< next free position along the shelf.
+		};	//!< a row of the atlas glyphs are placed along.
+
+		struct RasterGlyph
+		{
+			std::vector<unsigned char> pixels;		//!< tightly packed single channel pixels.
+			uint32_t width = 0;						//!< width in pixels.
+			uint32_t height = 0;					//!< height in pixels.
+			glm::vec2 bearing = glm::vec2(0.0f);	//!< offset from the pen position to the top left.
+			float advance = 0.0f;					//!< how far to move the pen on.
+		};	//!< a glyph on the CPU, between rasterising and going into the atlas.
+
+		bool rasterise(FT_Face face, uint32_t pixelSize, uint32_t codepoint, RasterGlyph& raster);	//!< have freetype render a glyph; main thread only, freetype faces aren't thread safe.
+		void generateSDF(RasterGlyph& raster) const;	//!< replace the coverage with a distance field, growing the glyph by the spread; touches nothing shared so can run on any thread.
+		const GlyphInfo& insert(const GlyphKey& key, const RasterGlyph& raster);	//!< pack a glyph into the atlas and upload it.
+		bool allocate(uint32_t width, uint32_t height, glm::uvec2& position);	//!< find space for a glyph; false if the atlas is full.
+
+		std::shared_ptr<Textures> m_texture;		//!< single channel atlas texture.
+		glm::uvec2 m_size;							//!< size of the atlas in pixels.
+		uint32_t m_padding;							//!< gap between glyphs so linear filtering doesn't bleed.
+		GlyphMode m_mode;							//!< what the atlas stores.
+		uint32_t m_spread;							//!< SDF only; distance in pixels either side of the edge the field covers.
+		std::vector<Shelf> m_shelves;				//!< the shelves, top to bottom.
+		std::unordered_map<GlyphKey, GlyphInfo, GlyphKeyHash> m_glyphs;	//!< every glyph seen so far.
+	};
+}
@@ -0,0 +1,21 @@
+/** \file meshSimplifier.h */
+#pragma once
+
+#include "rendering/bufferLayout.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Engine
+{
+	/* \class MeshSimplifier
+	*  \brief Quadric error edge collapse (Garland and Heckbert) for building mesh LODs. Only the indices change; every collapse moves a vertex onto
+	*  one of its neighbours, so the simplified mesh indexes the same vertices as the original and can share its vertex buffer. Vertices on open
+	*  borders and UV or normal seams (positions shared by more than one vertex) are never moved, so silhouettes and seams hold together.
+	*/
+	class MeshSimplifier
+	{
+	public:
+		static float simplify(const void* vertices, uint32_t vertexCount, const VertexBufferLayout& layout, const uint32_t* indices, uint32_t indexCount,
+			uint32_t targetIndexCount, float maxError, std::vector<uint32_t>& result);	//!< collapse edges until there are at most targetIndexCount indices, or the next collapse would move the surface by more than maxError; returns the largest error introduced, in the units of the positions. The layout has to start with a Float3 position, otherwise the indices are returned unchanged.
+	};
+}
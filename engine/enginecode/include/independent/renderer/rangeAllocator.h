@@ -0,0 +1,34 @@
+/** \file rangeAllocator.h */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+	/* \struct FreeRange
+	*  \brief A run of free elements.
+	*/
+	struct FreeRange
+	{
+		uint32_t start;		//!< first element.
+		uint32_t count;		//!< number of elements.
+	};
+
+	/* \class RangeAllocator
+	*  \brief Hands out runs of elements from a fixed capacity, first fit, and merges runs given back with the free runs either side, so freeing
+	*  everything always leaves one run again. Only the bookkeeping; what the elements are (vertices, indices) is up to the owner.
+	*/
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator(uint32_t capacity);						//!< constructor; everything starts free as one run.
+		bool allocate(uint32_t count, uint32_t& start);			//!< take count elements from the first free run big enough; false if none is.
+		void release(uint32_t start, uint32_t count);			//!< give elements back, merging with the runs either side.
+		inline uint32_t getFreeCount() const { return m_freeCount; }	//!< accessor for elements not in use (not necessarily in one run).
+		inline const std::vector<FreeRange>& getFreeRanges() const { return m_freeRanges; }	//!< accessor for the free runs, in order.
+	private:
+		std::vector<FreeRange> m_freeRanges;	//!< free runs, in order, never touching.
+		uint32_t m_freeCount;					//!< total free elements.
+	};
+}
\ No newline at end of file
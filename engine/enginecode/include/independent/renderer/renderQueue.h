@@ -0,0 +1,33 @@
+/** \file renderQueue.h */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+	/* \struct RenderQueueEntry
+	*  \brief A sort key and the index of the packet it belongs to; the packets themselves stay where they were recorded.
+	*/
+	struct RenderQueueEntry
+	{
+		uint64_t key;		//!< what the entries are ordered by, most significant bits first.
+		uint32_t index;		//!< index of the packet the key was made for.
+	};
+
+	/* \class RenderQueue
+	*  \brief Per frame list of sort keys, radix sorted so draws can be issued in state order rather than submission order.
+	*/
+	class RenderQueue
+	{
+	public:
+		inline void push(uint64_t key, uint32_t index) { m_entries.push_back({ key, index }); }	//!< record a packet's key.
+		void sort();				//!< stable LSD radix sort of the keys, a byte at a time.
+		inline void clear() { m_entries.clear(); }	//!< empty the queue, keeps the memory for next frame.
+		inline const std::vector<RenderQueueEntry>& getEntries() const { return m_entries; }	//!< accessor for the entries, sorted once sort() has been called.
+		inline uint32_t getCount() const { return m_entries.size(); }		//!< accessor for the number of entries.
+	private:
+		std::vector<RenderQueueEntry> m_entries;	//!< the entries.
+		std::vector<RenderQueueEntry> m_scratch;	//!< where each pass of the sort scatters to.
+	};
+}
@@ -1,11 +1,88 @@
 /** \file renderer2d.h */
 #pragma once
 #include "renderer/rendererCommons.h"
+#include "rendering/textureUnitManager.h"
+#include "rendering/subTexture.h"
+#include "renderer/glyphAtlas.h"
+#include "renderer/textRunCache.h"
+#include "renderer/renderQueue.h"
 #include "ft2build.h"
 #include "freetype/freetype.h"
+#include <array>
+#include <vector>
 
 namespace Engine
 {
+	/* \class Renderer2DVertex
+	*  \brief Class for a single vertex of a batched 2D quad; position, UV coordinates, texture unit and a packed tint.
+	*/
+	class Renderer2DVertex
+	{
+	public:
+		Renderer2DVertex() = default;		//!< default constructor.
+		Renderer2DVertex(const glm::vec2& position, const glm::vec2& UVCoords, uint32_t textureUnit, uint32_t tint) :
+			m_position(position),
+			m_UVCoords(UVCoords),
+			m_textureUnit(textureUnit),
+			m_tint(tint)
+		{}									//!< constructor with params; the tint is already packed into RGBA bytes (see GenFuncs::package).
+
+		glm::vec2 m_position;				//!< world position of the vertex, already transformed on the CPU.
+		glm::vec2 m_UVCoords;				//!< UV coordinates of the vertex.
+		uint32_t m_textureUnit;				//!< texture unit the vertex samples from.
+		uint32_t m_tint;					//!< tint packed into 4 bytes.
+
+		inline static VertexBufferLayout getBufferLayout() { return s_BufferLayout; }		//!< accessor function to get the static buffer layout.
+
+		constexpr static uint32_t flag_SDF = 1 << 8;	//!< set on the texture unit when the texture holds a distance field rather than colour; the low byte is still the unit.
+	private:
+		static VertexBufferLayout s_BufferLayout;	//!< the layout for the batch vertex buffer.
+	};
+
+	/* \class Renderer2DInstance
+	*  \brief Class for one instance of the shared unit quad; everything needed to place, texture and tint it in 32 bytes.
+	*/
+	class Renderer2DInstance
+	{
+	public:
+		Renderer2DInstance() = default;		//!< default constructor.
+		Renderer2DInstance(const glm::vec2& translate, const glm::vec2& scale, const glm::vec2& UVStart, const glm::vec2& UVEnd, float angle, uint32_t textureUnit, uint32_t tint);	//!< constructor with params; UVs and angle (radians) are packed into normalised shorts, the tint is already packed (see GenFuncs::package).
+
+		glm::vec2 m_translate;				//!< centre of the quad.
+		glm::vec2 m_scale;					//!< full size of the quad.
+		int16_t m_UVRect[4];				//!< UV start and end, normalised shorts.
+		int16_t m_angle;					//!< rotation as a normalised short, -1 to 1 being -pi to pi.
+		int16_t m_textureUnit;				//!< texture unit the instance samples from, plus any flags (see Renderer2DVertex::flag_SDF).
+		uint32_t m_tint;					//!< tint packed into 4 bytes.
+
+		inline static VertexBufferLayout getBufferLayout() { return s_BufferLayout; }		//!< accessor function to get the static buffer layout.
+	private:
+		static VertexBufferLayout s_BufferLayout;	//!< the layout for the instance buffer, with a divisor of 1.
+	};
+
+	/* \enum TextMode
+	*  \brief How Renderer2D rasterises text.
+	*/
+	enum class TextMode
+	{
+		Bitmap,		//!< glyphs rasterised at one size; sharp at that size only.
+		SDF			//!< glyphs stored as distance fields; one atlas is sharp at any size.
+	};
+
+	/* \struct Renderer2DStats
+	*  \brief Counters for the current 2D scene, reset each begin().
+	*/
+	struct Renderer2DStats
+	{
+		uint32_t drawCalls = 0;		//!< number of draw calls issued.
+		uint32_t quads = 0;			//!< number of quads drawn.
+		uint32_t bytesUploaded = 0;	//!< bytes of vertex or instance data sent to the GPU.
+		uint32_t textureBinds = 0;	//!< number of textures bound to units.
+		uint32_t packets = 0;		//!< number of quads and text runs submitted.
+		uint32_t culled = 0;		//!< submitted packets dropped for being outside the view.
+		uint32_t visible = 0;		//!< submitted packets that overlapped the view and were drawn.
+	};
+
 	/* \class Quad
 	*  \brief Class to create Quads for 2D rendering.
 	*/
@@ -25,41 +102,102 @@ namespace Engine
 	};
 
 	/* \class Renderer2D
-	*  \brief A renderer rendering simple 2D primitives.
+	*  \brief A renderer rendering simple 2D primitives. Submits are recorded and sorted at end(); layers draw in order, opaque quads within a layer are drawn
+	*  grouped by state (so overlapping opaque quads should be on different layers) and translucent quads and text after them in submission order.
 	*/
 	class Renderer2D
 	{
 	public:
-		static void init();					//!< initiate the internal data of the renderer.
-		static void	begin(const SceneWideUniforms& swu);								//!< begin a 2D scene.
+		static void init(TextMode textMode = TextMode::Bitmap);		//!< initiate the internal data of the renderer, and choose how text is rasterised.
+		static void	begin(const SceneWideUniforms& swu);								//!< begin a 2D scene; if the uniforms have u_view and u_projection, anything outside that view is culled.
 		static void submit(const Quad& quad, const glm::vec4& tint);					//!< render a tinted (coloured) quad.
 		static void submit(const Quad& quad, const std::shared_ptr<Textures>& texture);	//!< render a textured quad.
 		static void submit(const Quad& quad, const glm::vec4& tint, const std::shared_ptr<Textures>& texture);	//!< render a tinted & textured quad.
 		static void submit(const Quad& quad, const glm::vec4& tint, float angle, bool degrees = false);			//!< render a tinted & rotated quad.
 		static void submit(const Quad& quad, const std::shared_ptr<Textures>& texture, float angle, bool degrees = false);		//!< render a textured & rotated quad.
 		static void submit(const Quad& quad, const glm::vec4& tint, const std::shared_ptr<Textures>& texture, float angle, bool degrees = false);		//!< render a tinted, textured & rotated quad.
+		static void submit(const Quad& quad, const SubTexture& subTexture);							//!< render a quad textured from part of an atlas.
+		static void submit(const Quad& quad, const glm::vec4& tint, const SubTexture& subTexture, float angle = 0.0f, bool degrees = false);		//!< render a tinted & rotated quad textured from part of an atlas.
 
 		static void submit(char ch, const glm::vec2& position, float& advance, const glm::vec4& tint);	//!< render a single character, with tint.
 		static void submit(const char* text, const glm::vec2& position, const glm::vec4& tint);			//!< render a string, with tint.
+		static void submit(const char* text, const glm::vec2& position, const glm::vec4& tint, float pixelSize);	//!< render a string, with tint, at a given pixel size.
 
-		static void end();					//!< end of the current 2D scene.
+		static void setLayer(uint8_t layer);	//!< layer for everything submitted after this; higher layers draw over lower ones. Back to 0 each begin().
+		static void end();					//!< end of the current 2D scene; sorts everything submitted and draws it.
+		static void endFrame();				//!< end of the frame, however many 2D scenes it had; cached text runs age by frames, so call it once a frame.
+		static const Renderer2DStats& getStats() { return s_data->stats; }	//!< accessor for the counters of the current 2D scene.
+		static void setInstanced(bool instanced);		//!< switch between expanding quads into the batch on the CPU and instancing the unit quad, for everything submitted after this.
+		inline static bool isInstanced() { return s_data->instanced; }	//!< whether quads are currently drawn instanced.
 	private:
+		struct Packet
+		{
+			glm::vec2 centre;		//!< centre of the quad, or the pen position of a text run.
+			glm::vec2 size;			//!< size of the quad; x is the scale of a text run.
+			glm::vec2 UVStart;		//!< top left UV.
+			glm::vec2 UVEnd;		//!< bottom right UV.
+			float angle;			//!< rotation in radians.
+			uint32_t tint;			//!< packed tint.
+			uint32_t textureID;		//!< texture sampled.
+			uint32_t unitFlags;		//!< flags added to the texture unit (see Renderer2DVertex::flag_SDF).
+			bool instanced;			//!< which path draws it.
+			const TextRun* run;		//!< the text run, nullptr for a plain quad; runs live until the text run cache's endFrame().
+		};	//!< a recorded submit, waiting to be sorted.
+
 		struct InternalData
 		{
 			std::shared_ptr<Textures> defaultTexture;	//!< empty white texture.
 			std::shared_ptr<Shaders> shader;			//!< the shader used.
-			std::shared_ptr<VertexArray> VAO;			//!< prototypical quad for submitting (don't use geometry/VAO in 2d)
+			std::shared_ptr<VertexArray> VAO;			//!< prototypical quad, drawn once per instance on the instanced path.
 			glm::vec4 defaultTint;						//!< default white tint.
 			glm::mat4 model;							//!< transform the the model.
 
+			uint32_t batchCapacity;						//!< max number of quads in a single batch.
+			uint32_t batchQuadCount;					//!< number of quads currently in the batch.
+			std::vector<Renderer2DVertex> batchVertices;	//!< CPU side vertices for the batch, 4 per quad.
+			std::shared_ptr<VertexBuffer> batchVBO;		//!< vertex buffer the batch is uploaded into.
+			std::shared_ptr<VertexArray> batchVAO;		//!< vertex array for the batch, IBO holds 6 indices per quad.
+			TextureUnitManager textureUnitManager;		//!< which textures are bound to which units within the current batch.
+			std::array<int32_t, 16> textureUnits;		//!< the units the batch shader can sample from.
+
+			bool instanced;								//!< draw quads by instancing the prototypical quad rather than through the batch.
+			std::shared_ptr<Shaders> instanceShader;	//!< shader that places the prototypical quad per instance.
+			std::vector<Renderer2DInstance> instances;	//!< CPU side instances, 1 per quad; shares the batch capacity and count.
+			std::shared_ptr<VertexBuffer> instanceVBO;	//!< per instance buffer attached to the prototypical quad's VAO.
+			bool drawingInstanced;						//!< which path the quads currently in the batch are for.
+
+			std::vector<Packet> packets;				//!< everything submitted this scene.
+			std::vector<uint64_t> packetKeys;			//!< sort key of each packet, queued once it survives culling.
+			std::vector<float> boundsMinX;				//!< left of each packet's bounding box; the bounds are kept as separate arrays so they can be tested four at a time.
+			std::vector<float> boundsMinY;				//!< top of each packet's bounding box.
+			std::vector<float> boundsMaxX;				//!< right of each packet's bounding box.
+			std::vector<float> boundsMaxY;				//!< bottom of each packet's bounding box.
+			bool culling;								//!< whether this scene has a view to cull against.
+			glm::vec2 viewMin;							//!< top left of the world space view rectangle.
+			glm::vec2 viewMax;							//!< bottom right of the world space view rectangle.
+			RenderQueue queue;							//!< sort keys for the packets.
+			uint8_t layer;								//!< layer new packets are recorded on.
+			Renderer2DStats stats;						//!< counters for the current scene.
+
 			FT_Library ft;								//!< the freetype library.
 			FT_Face fontFace;							//!< the font face.
-			std::shared_ptr<Textures> fontTexture;		//!< texture for the font.
-			glm::ivec2 glyphBufferDimensions;			//!< dimensions for the buffer size for the glyphs.
-			uint32_t glyphBufferSize;					//!< the size of the glyph.
-			std::shared_ptr<unsigned char> glyphBuffer;	//!< the buffer for glyphs.
+			uint32_t fontSize;							//!< pixel size glyphs are rasterised into the atlas at.
+			float textSize;								//!< pixel size text is drawn at when none is given.
+			uint32_t textFlags;							//!< flags added to the texture unit of glyph quads (see Renderer2DVertex::flag_SDF).
+			std::shared_ptr<GlyphAtlas> glyphAtlas;		//!< every glyph drawn so far, rasterised once on first use (or up front in SDF mode).
+			std::shared_ptr<TextRunCache> textRuns;		//!< strings already laid out, so unchanged text isn't laid out again each frame.
 		};
 		static std::shared_ptr<InternalData> s_data;	//!< data internal to the renderer.
-		static void RtoRGBA(unsigned char * rBuffer, uint32_t width, uint32_t height);		//!< method to set memory block and fill with glyph(rbuffer) data.
+		static void recordQuad(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureID, const glm::vec2& UVStart, const glm::vec2& UVEnd, bool translucent, uint32_t unitFlags = 0);	//!< record a quad to be sorted and drawn at end().
+		static void recordTextRun(const TextRun& run, const glm::vec2& position, uint32_t tint, float scale);	//!< record a text run to be sorted and drawn at end(); text is always translucent.
+		static void recordPacket(const Packet& packet, uint64_t key, const glm::vec2& boundsMin, const glm::vec2& boundsMax);	//!< store a packet with its key and bounds.
+		static void cullPackets();		//!< queue the key of every packet that overlaps the view, four packets per test.
+		static uint64_t makeSortKey(bool translucent, uint32_t shader, uint32_t textureID, uint32_t depth);	//!< build the 64 bit key a packet is sorted by.
+		static bool isTranslucent(const glm::vec4& tint, const std::shared_ptr<Textures>& texture);	//!< whether a quad may need what is under it.
+		static void appendQuad(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureID, const glm::vec2& UVStart, const glm::vec2& UVEnd, uint32_t unitFlags = 0);	//!< transform the quad corners on the CPU and add them to the batch.
+		static void appendTextRun(const TextRun& run, const glm::vec2& position, uint32_t tint, float scale);	//!< copy a laid out text run into the batch as one block, scaled from the atlas size.
+		static uint32_t getTextureUnit(uint32_t textureID);	//!< get the unit for a texture within the batch, flushing first if all units are taken.
+		static void appendInstance(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureUnit, const glm::vec2& UVStart, const glm::vec2& UVEnd);	//!< add a quad to the batch as a single instance record.
+		static void flushBatch();							//!< upload the batch and draw it with a single draw call.
 	};
 }
\ No newline at end of file
@@ -1,6 +1,16 @@
 /** \file renderer3D.h */
 #pragma once
 #include "renderer/rendererCommons.h"
+#include "renderer/renderQueue.h"
+#include "renderer/geometryPool.h"
+#include "renderer/aabbTree.h"
+#include "renderer/shaderVariants.h"
+#include "rendering/ringBuffer.h"
+#include "rendering/storageBuffer.h"
+#include "rendering/blockLayout.h"
+#include <cstddef>
+#include <array>
+#include <vector>
 
 namespace Engine
 {
@@ -18,7 +28,8 @@ namespace Engine
 	};
 
 	/* \class Material
-	*  \brief Holds a shader and all the uniform data that is associated with specific shader.
+	*  \brief Holds a shader and all the uniform data that is associated with specific shader. Given shader variants instead of a shader, it is
+	*  drawn with the variant built for its flags, each flag defined as in getDefines.
 	*/
 	class Material
 	{
@@ -26,12 +37,7 @@ namespace Engine
 		Material(const std::shared_ptr<Shaders>& shader, const TextureTypeStruct& texture, const glm::vec4& tint) :
 			m_shader(shader)
 		{
-			if (texture.diffuseTexture) setDiffuseTexture(texture.diffuseTexture);
-			if (texture.specularTexture) setSpecularTexture(texture.specularTexture);
-			if (texture.reflectionTexture) setReflectionTexture(texture.reflectionTexture);
-			if (texture.emmisiveTexture) setEmmisiveTexture(texture.emmisiveTexture);
-			if (texture.normalTexture) setNormalTexture(texture.normalTexture);
-			if (texture.defaultTexture) setDefaultTexture(texture.defaultTexture);
+			setTextures(texture);
 
 			if (m_flags == 0)
 			{ 
@@ -43,15 +49,30 @@ namespace Engine
 			m_shader(shader),
 			m_tint(0.0f)
 		{
-			if (texture.diffuseTexture) setDiffuseTexture(texture.diffuseTexture);
-			if (texture.specularTexture) setSpecularTexture(texture.specularTexture);
-			if (texture.reflectionTexture) setReflectionTexture(texture.reflectionTexture);
-			if (texture.emmisiveTexture) setEmmisiveTexture(texture.emmisiveTexture);
-			if (texture.normalTexture) setNormalTexture(texture.normalTexture);
-			if (texture.defaultTexture) setDefaultTexture(texture.defaultTexture);
+			setTextures(texture);
 		}			//!< constructor taking shader and texture within within the params, initialised within the initialiser list, flag for texture set within function.
 
-		inline std::shared_ptr<Shaders> getShader() const { return m_shader; }		//!< accessor function for getting the shader.
+		Material(const std::shared_ptr<ShaderVariants>& variants, const TextureTypeStruct& texture, const glm::vec4& tint) :
+			m_variants(variants)
+		{
+			setTextures(texture);
+
+			if (m_flags == 0)
+			{
+				setTint(tint);
+			}
+		}			//!< constructor with shader variants instead of a shader, and a tint if there are no textures.
+
+		Material(const std::shared_ptr<ShaderVariants>& variants, const TextureTypeStruct& texture) :
+			m_variants(variants),
+			m_tint(0.0f)
+		{
+			setTextures(texture);
+		}			//!< constructor with shader variants instead of a shader.
+
+		inline const std::shared_ptr<Shaders>& getShader() const { return m_shader; }		//!< accessor function for getting the shader.
+		inline const std::shared_ptr<ShaderVariants>& getShaderVariants() const { return m_variants; }	//!< accessor for the shader variants, if it is drawn with those instead.
+		static std::vector<std::string> getDefines(uint32_t flags);	//!< the define for each flag set, to pick a variant: MATERIAL_DIFFUSE_TEXTURE, MATERIAL_SPECULAR_TEXTURE and so on, MATERIAL_TINT.
 		inline std::shared_ptr<Textures> getTexture(uint32_t textureFlag) const;	//!< accessor function for getting the texture.
 		inline glm::vec4 getTint() const { return m_tint; }		//!< accessor function to get the tint.
 
@@ -110,32 +131,234 @@ namespace Engine
 	private:
 		uint32_t m_flags = 0;						//!< bitfield representation of the shader settings.
 		std::shared_ptr<Shaders> m_shader;			//!< the shader.
-		std::array<std::shared_ptr<Textures>, 5> m_texture;			//!< the texture for the material.
+		std::shared_ptr<ShaderVariants> m_variants;	//!< the variants to pick a shader from, in place of the shader.
+		std::array<std::shared_ptr<Textures>, 6> m_texture;			//!< the texture for the material.
 		glm::vec4 m_tint;							//!< coloured tint to be applied to the geometry.
 		void setFlag(uint32_t flag) { m_flags = m_flags | flag; }	//!< function to set the flag.
+		void setTextures(const TextureTypeStruct& texture)
+		{
+			if (texture.diffuseTexture) setDiffuseTexture(texture.diffuseTexture);
+			if (texture.specularTexture) setSpecularTexture(texture.specularTexture);
+			if (texture.reflectionTexture) setReflectionTexture(texture.reflectionTexture);
+			if (texture.emmisiveTexture) setEmmisiveTexture(texture.emmisiveTexture);
+			if (texture.normalTexture) setNormalTexture(texture.normalTexture);
+			if (texture.defaultTexture) setDefaultTexture(texture.defaultTexture);
+		}	//!< set every texture given and its flag.
+	};
+
+	/* \class MaterialHandle
+	*  \brief A material baked into Renderer3D by createMaterial. Just an index, so passing it around and storing it per draw costs nothing.
+	*/
+	class MaterialHandle
+	{
+	public:
+		MaterialHandle() = default;											//!< default constructor, invalid.
+		explicit MaterialHandle(uint32_t index) : m_index(index) {}		//!< constructor with the index of the baked material.
+		inline uint32_t getIndex() const { return m_index; }				//!< accessor for the index.
+		inline bool isValid() const { return m_index != 0xFFFFFFFF; }		//!< whether it refers to a material.
+	private:
+		uint32_t m_index = 0xFFFFFFFF;	//!< index of the baked material.
+	};
+
+	/* \struct Renderer3DStats
+	*  \brief Counters for the current 3D scene, reset each begin().
+	*/
+	struct Renderer3DStats
+	{
+		uint32_t draws = 0;				//!< number of draw calls issued; each is a multi draw of one or more commands.
+		uint32_t commands = 0;			//!< number of indirect draw commands, one per submit.
+		uint32_t shaderBinds = 0;		//!< number of times the program changed.
+		uint32_t drawDataBytes = 0;		//!< bytes of per draw data written to the ring buffer.
+		uint32_t textureBinds = 0;		//!< number of material binding tables bound.
+		uint32_t VAOBinds = 0;			//!< number of vertex arrays bound.
+		uint32_t instances = 0;			//!< number of instances drawn by instanced draws.
+		uint32_t visible = 0;			//!< number of objects and instances that passed the frustum test.
+		uint32_t culled = 0;			//!< number of objects and instances outside the frustum, never recorded.
+		uint32_t nodesTested = 0;		//!< number of object tree nodes tested against the frustum.
+		uint32_t materialBytes = 0;		//!< bytes of material parameters uploaded, 0 unless a material changed.
+		uint32_t triangles = 0;			//!< number of triangles drawn, after culling and LOD selection.
+		uint32_t waiting = 0;			//!< number of objects and instances not drawn because their shader is still compiling and there is no fallback.
 	};
 
 	/* \class Renderer3D
-	*  \brief A renderer renders 3D geometry instantly (not batched), that uses OpenGL.
+	*  \brief A renderer for 3D geometry that uses OpenGL. Submits are recorded and drawn at end(), sorted by shader, texture binding table and
+	*  vertex array so only the state that changes between draws is set; opaque geometry draws front to back, translucent (tint alpha below 1)
+	*  back to front after it.
+	*  Materials are baked once by createMaterial: their parameters go into a std140 storage block that is only uploaded when a material changes,
+	*  and their textures into a binding table with a unit per slot, shared by every material with the same textures. A draw only carries the
+	*  material's index. Materials with shader variants get the variant for their flags, so their flags are decided once when baked rather than
+	*  branched on per pixel.
+	*  Each instance's draw data goes into a ring buffer in one contiguous write per scene; shaders read it from the b_draws storage block,
+	*  indexed by gl_BaseInstanceARB + gl_InstanceID, so there are no per draw uniform uploads. The MVP and normal matrices are worked out once
+	*  per instance here rather than once per vertex in the shader, four instances at a time with SSE and spread over the job system for big scenes.
+	*  Every submit becomes an indirect draw command in the same ring, and each run of commands sharing shader, binding table and vertex array is
+	*  one glMultiDrawElementsIndirect; meshes in a GeometryPool share a vertex array, so they batch together.
+	*  Everything is culled against the camera frustum first. Submits are tested one box (per instance) at a time; objects added with addObject
+	*  stay between scenes in a dynamic AABB tree, so whole branches off screen are skipped with one test and moving them only touches the tree
+	*  when they leave their fattened box.
+	*  Meshes added to a GeometryPool with levels of detail draw the coarsest LOD their projected bounding sphere allows; objects keep the LOD they
+	*  drew last scene until the size is lodHysteresis past the threshold, so they don't pop back and forth.
+	*  Shaders made with Shaders::createAsync can be given to materials straight away; until one has linked its materials draw with the fallback
+	*  shader, or not at all if there isn't one, so a level bringing in new shaders doesn't stall the frame waiting on the driver.
 	*/
 	class Renderer3D
 	{
 	public:
 		static void init();												//!< initiate the renderer.
+		static MaterialHandle createMaterial(const Material& material);	//!< bake a material's parameters and textures; the handle is what submits take.
+		static void updateMaterial(MaterialHandle handle, const Material& material);	//!< bake a material again in place, after its textures or tint have changed.
+		static void setMaterialTint(MaterialHandle handle, const glm::vec4& tint);	//!< change just the tint of a baked material.
+		static void destroyMaterial(MaterialHandle handle);				//!< release a baked material; its handle can be handed out again.
 		static void begin(const SceneWideUniforms& sceneWideUniforms);	//!< begin a new 3D scene.
-		static void submit(const std::shared_ptr<VertexArray>& geometry, const std::shared_ptr<Material> material, const glm::mat4& model);		//!< submit a new piece of geometry to be rendered.
-		static void end();												//!< end of the current 3D scene.
-		static void attachShader(std::shared_ptr<Shaders> shader);		//!< attach the shader.
+		static void submit(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4& model);		//!< submit a new piece of geometry to be rendered at end(); it has to live until then.
+		static void submitInstanced(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4* models, uint32_t count);	//!< submit many copies of a piece of geometry, drawn with one call.
+		static void submitInstanced(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const std::vector<glm::mat4>& models) { submitInstanced(geometry, material, models.data(), models.size()); }	//!< submit many copies of a piece of geometry, drawn with one call.
+		static void submit(const std::shared_ptr<GeometryPool>& pool, const MeshRange& mesh, MaterialHandle material, const glm::mat4& model);	//!< submit a mesh from a geometry pool.
+		static void submitInstanced(const std::shared_ptr<GeometryPool>& pool, const MeshRange& mesh, MaterialHandle material, const glm::mat4* models, uint32_t count);	//!< submit many copies of a mesh from a geometry pool.
+		static uint32_t addObject(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4& model);	//!< add geometry that is drawn every scene it is visible in, until removed; returns its id.
+		static uint32_t addObject(const std::shared_ptr<GeometryPool>& pool, const MeshRange& mesh, MaterialHandle material, const glm::mat4& model);	//!< add a mesh from a geometry pool that is drawn every scene it is visible in, until removed; returns its id.
+		static void setObjectTransform(uint32_t object, const glm::mat4& model);	//!< move an object.
+		static void removeObject(uint32_t object);						//!< stop drawing an object; its id can be handed out again.
+		static void end();												//!< end of the current 3D scene; culls, sorts and draws everything submitted and every visible object.
+		static const Renderer3DStats& getStats() { return s_data->stats; }	//!< accessor for the counters of the current 3D scene.
+		static void attachShader(std::shared_ptr<Shaders> shader);		//!< attach the shader; one still compiling is attached once it has linked.
+		static void setFallbackShader(std::shared_ptr<Shaders> shader);	//!< what materials draw with while their own shader compiles; it reads the same blocks, and is waited on here if it hasn't linked.
+
+		constexpr static float lodHysteresis = 0.15f;	//!< how far past a LOD's threshold, as a fraction of it, an object's size has to go before it changes LOD.
+		constexpr static uint32_t textureSlots = 5;	//!< diffuse, specular, reflection, emmisive and normal, bound to units 0 to 4 in that order.
 	private:
+		struct DrawItem
+		{
+			VertexArray* geometry;						//!< the vertex array drawn from; the submitter keeps it alive until end().
+			uint32_t indexCount;						//!< indices to draw.
+			uint32_t firstIndex;						//!< first index in the vertex array's index buffer.
+			uint32_t baseVertex;						//!< added to every index, for meshes in a pool.
+			uint32_t material;							//!< index of the baked material.
+			uint32_t firstInstance;						//!< where its models start in instanceModels, then where its draw data starts once written.
+			uint32_t instanceCount;						//!< number of instances, 1 for a plain submit.
+		};	//!< a recorded submit, waiting to be sorted.
+
+		struct DrawData
+		{
+			glm::mat4 model;							//!< the model matrix, for world space lighting.
+			glm::mat4 MVP;								//!< projection * view * model.
+			glm::vec4 normalMatrix[3];					//!< inverse transpose of the model's upper 3x3, as std430 lays out a mat3.
+			uint32_t material;							//!< index into the material parameter block.
+			uint32_t padding[3];						//!< the struct is padded to 16 bytes in std430.
+		};	//!< what a shader reads per instance; matches DrawData in the shaders, std430.
+		using DrawDataLayout = BlockLayout<BlockRules::Std430, glm::mat4, glm::mat4, glm::mat3, uint32_t>;	//!< DrawData as the shaders declare it.
+		static_assert(offsetof(DrawData, MVP) == DrawDataLayout::offset<1> && offsetof(DrawData, normalMatrix) == DrawDataLayout::offset<2> &&
+			offsetof(DrawData, material) == DrawDataLayout::offset<3> && sizeof(DrawData) == DrawDataLayout::size, "DrawData doesn't match its std430 layout");
+
+		struct DrawCommand
+		{
+			uint32_t count;								//!< indices to draw.
+			uint32_t instanceCount;						//!< instances to draw.
+			uint32_t firstIndex;						//!< first index.
+			int32_t baseVertex;							//!< added to every index.
+			uint32_t baseInstance;						//!< where the draw data starts.
+		};	//!< GL's DrawElementsIndirectCommand.
+
+		struct MaterialParameters
+		{
+			glm::vec4 tint;								//!< the tint, or white.
+			uint32_t flags;								//!< the material's flags, so shaders know which slots hold a texture.
+			uint32_t padding[3];						//!< the struct is padded to 16 bytes in std140.
+		};	//!< a material's parameters as shaders read them; matches MaterialParameters in the shaders, std140.
+		using MaterialParametersLayout = BlockLayout<BlockRules::Std140, glm::vec4, uint32_t>;	//!< MaterialParameters as the shaders declare it.
+		static_assert(offsetof(MaterialParameters, flags) == MaterialParametersLayout::offset<1> && sizeof(MaterialParameters) == MaterialParametersLayout::size,
+			"MaterialParameters doesn't match its std140 layout");
+
+		struct LightingBlock
+		{
+			alignas(16) glm::vec3 lightPos;				//!< where the light is.
+			alignas(16) glm::vec3 viewPos;				//!< where the camera is.
+			alignas(16) glm::vec3 lightColour;			//!< the light's colour.
+		};	//!< the b_lights uniform block, copied over it whole each scene.
+		using LightingLayout = BlockLayout<BlockRules::Std140, glm::vec3, glm::vec3, glm::vec3>;	//!< b_lights as the shaders declare it.
+		static_assert(offsetof(LightingBlock, viewPos) == LightingLayout::offset<1> && offsetof(LightingBlock, lightColour) == LightingLayout::offset<2> &&
+			sizeof(LightingBlock) == LightingLayout::size, "LightingBlock doesn't match its std140 layout");
+
+		struct BakedMaterial
+		{
+			std::shared_ptr<Shaders> shader;			//!< keeps the shader alive for as long as the material is.
+			std::shared_ptr<ShaderVariants> variants;	//!< where the shader came from, to pick another if the flags change.
+			uint32_t shaderID;							//!< the program drawn with; the fallback's while the shader compiles, 0 for nothing.
+			uint32_t bindingTable;						//!< index of its texture binding table.
+			bool translucent;							//!< drawn back to front after everything opaque.
+		};	//!< what a draw needs of a material, looked up by index.
+
+		struct SceneObject
+		{
+			std::shared_ptr<VertexArray> geometry;		//!< the vertex array drawn from.
+			std::array<MeshLOD, MeshRange::maxLODs> lods;	//!< index ranges of each level of detail; just the one for geometry not from a pool.
+			uint32_t lodCount;							//!< levels of detail in use.
+			uint32_t lod;								//!< the level drawn last scene, for hysteresis.
+			uint32_t baseVertex;						//!< added to every index, for meshes in a pool.
+			MaterialHandle material;					//!< the baked material.
+			glm::mat4 model;							//!< the model matrix.
+			AABB localBounds;							//!< bounds before the model is applied; invalid if the geometry has none, and then it is never culled.
+			int32_t proxy;								//!< its leaf in the object tree, or AABBTree::nullNode.
+		};	//!< geometry kept between scenes.
+
+		struct BindingTable
+		{
+			std::array<std::shared_ptr<Textures>, textureSlots> textures;	//!< the texture on each unit, kept alive for as long as the table is used.
+			std::array<uint32_t, textureSlots> IDs;		//!< the ID of each texture, 0 for an empty unit.
+			uint32_t users = 0;							//!< materials baked with the table; it is released when the last one goes.
+		};	//!< a set of textures, a unit per slot, shared by every material with the same textures.
+
 		struct InternalData
 		{
 			SceneWideUniforms sceneWideUniforms;		//!< replace with UBO in the future.
+			std::vector<DrawItem> drawItems;			//!< everything submitted this scene.
+			RenderQueue queue;							//!< sort keys for the draw items.
+			glm::vec3 viewPosition;						//!< where the camera is, for depth sorting.
+			glm::mat4 viewProjection;					//!< projection * view, for the MVPs.
+			float projectionScale;						//!< cot of half the vertical field of view, to get sizes on screen.
+			std::array<std::vector<glm::mat4>, MeshRange::maxLODs> lodModels;	//!< an instanced submit's models, split by LOD.
+			Renderer3DStats stats;						//!< counters for the current scene.
+			std::vector<glm::mat4> instanceModels;		//!< models of every submit this scene, back to back.
+			std::vector<glm::mat4> sortedModels;		//!< the same models in draw order, read by the transform stage.
+			std::vector<uint32_t> sortedMaterials;		//!< the material of each model in draw order.
+			std::shared_ptr<RingBuffer> drawData;		//!< per draw data, a section per scene in flight.
+			std::vector<BakedMaterial> materials;		//!< every baked material, indexed by handle; released ones have no shader.
+			std::vector<uint32_t> freeMaterials;		//!< handles of released materials.
+			std::vector<MaterialParameters> materialParameters;	//!< CPU copy of the material block, a struct per material.
+			uint32_t dirtyBegin = 0xFFFFFFFF;			//!< first material whose parameters have changed since the last upload.
+			uint32_t dirtyEnd = 0;						//!< one past the last; nothing to upload when it isn't past dirtyBegin.
+			std::shared_ptr<StorageBuffer> materialBuffer;	//!< the material block shaders read, grown as materials are added.
+			std::vector<BindingTable> bindingTables;	//!< every distinct set of textures materials use; released ones have no users.
+			std::vector<uint32_t> freeBindingTables;	//!< indices of released binding tables.
+			Frustum frustum;							//!< what the camera sees this scene.
+			std::vector<SceneObject> objects;			//!< every object, indexed by id; removed ones have no geometry.
+			std::vector<uint32_t> freeObjects;			//!< ids of removed objects.
+			std::vector<uint32_t> unboundedObjects;		//!< ids of objects without bounds, drawn every scene.
+			AABBTree objectTree;						//!< world bounds of every object with bounds.
+			std::vector<uint32_t> visibleObjects;		//!< ids of the objects found visible this scene.
 			std::shared_ptr<Textures> defaultTexture;	//!< empty white texture.
 			glm::vec4 defaultTint;						//!< default white tint.
 			std::shared_ptr<VertexArray> VAO;			//!< the vertex array.
-			std::shared_ptr<UniformBuffer> cameraUBO;	//!< UBO for the camera.
 			std::shared_ptr<UniformBuffer> lightingUBO;	//!< UBO for the lighting.
+			std::shared_ptr<Shaders> fallbackShader;	//!< drawn with in place of shaders still compiling.
+			std::vector<std::shared_ptr<Shaders>> pendingShaders;	//!< shaders still compiling, set up once they have linked.
 		};												//!< to be used as PURE data.
 		static std::shared_ptr<InternalData> s_data;	//!< data internal to the renderer.
+		static void bake(uint32_t index, const Material& material);	//!< fill in a baked material and its parameters from a material.
+		static void prepareShader(const std::shared_ptr<Shaders>& shader);	//!< set the samplers and lighting block of a shader, or put it off until it has linked.
+		static void pollShaders();									//!< set up every pending shader that has linked and move its materials onto it.
+		static uint32_t getDrawnShaderID(const std::shared_ptr<Shaders>& shader);	//!< the program to draw a shader's materials with now.
+		static uint32_t findBindingTable(const Material& material);	//!< the index of the binding table for a material's textures, adding it if it's new; the material is counted as one of its users.
+		static void releaseBindingTable(uint32_t index);			//!< a material no longer uses a binding table; the last user releases it and its textures.
+		static void uploadMaterials();								//!< upload the parameters of every material changed since the last upload and bind the block.
+		static uint64_t makeSortKey(const DrawItem& item);			//!< build the 64 bit key a draw item is sorted by.
+		static AABB getBounds(const std::shared_ptr<VertexArray>& geometry);	//!< bounds of every vertex buffer of a vertex array.
+		static float getScreenSize(const AABB& localBounds, const glm::mat4& model);	//!< radius of the bounding sphere over half the screen height.
+		static uint32_t selectLOD(const MeshLOD* lods, uint32_t lodCount, float screenSize, uint32_t current);	//!< the LOD to draw at a screen size, staying with current inside the hysteresis band; current past the last LOD for none.
+		static uint32_t addObject(const SceneObject& object);		//!< give an object an id and put it in the tree.
+		static void record(VertexArray* geometry, uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex, MaterialHandle material, const glm::mat4* models, uint32_t count, const AABB* localBounds);	//!< record a submit to be sorted, dropping models whose bounds are outside the frustum; no bounds means no culling.
+		static bool writeFrameData(uint32_t& commandOffset);		//!< write every instance's draw data and every draw command in sorted order into the ring buffer and bind it, growing it if needed.
+		static void transformInstances(const glm::mat4* models, const uint32_t* materials, uint32_t count, const glm::mat4& viewProjection, DrawData* drawData);	//!< the transform stage; work out the draw data of a run of instances, four at a time.
+		constexpr static uint32_t parallelTransformCount = 4096;	//!< instances in a scene before the transform stage is split across the job system.
 	};
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+/** \file shaderVariants.h */
+#pragma once
+
+#include "rendering/shaders.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine
+{
+	/* \class ShaderVariants
+	*  \brief A single-file shader built as specialised variants, one per set of defines, so each variant runs only the code it needs instead of
+	*  branching at runtime. A variant is compiled, asynchronously, the first time it is asked for; every ShaderVariants of the same source shares
+	*  them, keyed by a hash of the source with its includes and the define set. The cache only holds variants something else is using.
+	*/
+	class ShaderVariants
+	{
+	public:
+		ShaderVariants(const char* filePath);	//!< constructor, reads and hashes the source; nothing is compiled until a variant is asked for.
+		std::shared_ptr<Shaders> get(std::vector<std::string> defines);	//!< the variant for a set of defines, in any order.
+		inline const std::string& getFilePath() const { return m_filePath; }	//!< accessor for the file the variants are built from.
+	private:
+		std::string m_filePath;		//!< the single-file source.
+		uint64_t m_sourceHash;		//!< hash of the source with its includes resolved.
+		static std::unordered_map<uint64_t, std::weak_ptr<Shaders>> s_variants;	//!< every variant still in use, by source and define set.
+	};
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/** \file textRunCache.h */
+#pragma once
+
+#include "renderer/glyphAtlas.h"
+#include <string>
+
+namespace Engine
+{
+	/* \struct TextRunGlyph
+	*  \brief A single laid out glyph of a text run; positions are relative to the pen start of the run.
+	*/
+	struct TextRunGlyph
+	{
+		glm::vec2 min;			//!< top left of the glyph quad.
+		glm::vec2 max;			//!< bottom right of the glyph quad.
+		glm::vec2 UVStart;		//!< top left UV within the glyph atlas.
+		glm::vec2 UVEnd;		//!< bottom right UV within the glyph atlas.
+	};
+
+	/* \struct TextRun
+	*  \brief A whole string laid out once (advances and kerning applied), ready to be copied into the 2D batch.
+	*/
+	struct TextRun
+	{
+		std::vector<TextRunGlyph> glyphs;	//!< the glyphs that have something to draw.
+		float width = 0.0f;					//!< total advance of the run.
+		glm::vec2 boundsMin = glm::vec2(0.0f);	//!< top left of the glyphs' bounding box.
+		glm::vec2 boundsMax = glm::vec2(0.0f);	//!< bottom right of the glyphs' bounding box.
+		uint32_t lastUsedFrame = 0;			//!< frame the run was last drawn, for eviction.
+	};
+
+	/* \class TextRunCache
+	*  \brief Cache of laid out text runs keyed by string, font face and pixel size; runs not drawn for a while are evicted.
+	*/
+	class TextRunCache
+	{
+	public:
+		TextRunCache(const std::shared_ptr<GlyphAtlas>& atlas, uint32_t maxUnusedFrames = 120);		//!< constructor; the atlas glyphs come from and how many frames a run can go unused before eviction.
+		const TextRun& getRun(const char* text, FT_Face face, uint32_t pixelSize);	//!< get a run, laying it out only if it isn't cached.
+		void endFrame();								//!< move the frame counter on and evict any runs that have gone unused for too long; once per frame, not per scene.
+		inline uint32_t getRunCount() const { return m_runs.size(); }	//!< accessor for the number of runs cached.
+	private:
+		struct RunKey
+		{
+			std::string text;		//!< the string.
+			FT_Face face;			//!< the font face.
+			uint32_t pixelSize;		//!< pixel size of the font.
+			bool operator==(const RunKey& other) const { return face == other.face && pixelSize == other.pixelSize && text == other.text; }	//!< equality for the map.
+		};	//!< what a run is cached against.
+
+		struct RunKeyHash
+		{
+			size_t operator()(const RunKey& key) const;		//!< hash the three parts of the key together.
+		};	//!< hash for the run map.
+
+		void layout(TextRun& run, const char* text, FT_Face face, uint32_t pixelSize);	//!< lay out the glyphs of a run, including kerning.
+
+		std::shared_ptr<GlyphAtlas> m_atlas;		//!< atlas the glyphs are drawn from.
+		std::unordered_map<RunKey, TextRun, RunKeyHash> m_runs;		//!< every run in use.
+		uint32_t m_frame = 0;						//!< frames ended so far; runs are stamped with it when used.
+		uint32_t m_maxUnusedFrames;					//!< frames a run can go unused before it is evicted.
+	};
+}
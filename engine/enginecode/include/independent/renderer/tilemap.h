@@ -0,0 +1,86 @@
+/** \file tilemap.h */
+#pragma once
+
+#include "renderer/rendererCommons.h"
+#include <array>
+#include <vector>
+
+namespace Engine
+{
+	/* \class TilemapVertex
+	*  \brief Class for a single vertex of a baked tilemap chunk; the corner in tiles from the chunk origin and its UV in the tileset.
+	*/
+	class TilemapVertex
+	{
+	public:
+		TilemapVertex() = default;		//!< default constructor.
+		TilemapVertex(const std::array<int16_t, 2>& UVCoords, uint8_t x, uint8_t y) :
+			m_UVCoords(UVCoords),
+			m_corner({ x, y }),
+			m_padding({ 0, 0 })
+		{}								//!< constructor with params; UVs as normalised shorts (see GenFuncs::normalise), corner in tiles.
+
+		std::array<int16_t, 2> m_UVCoords;	//!< UV within the tileset, normalised shorts.
+		std::array<uint8_t, 2> m_corner;	//!< corner in tiles from the chunk origin.
+		std::array<uint8_t, 2> m_padding;	//!< keeps each vertex 4 byte aligned.
+
+		inline static VertexBufferLayout getBufferLayout() { return s_BufferLayout; }		//!< accessor function to get the static buffer layout.
+	private:
+		static VertexBufferLayout s_BufferLayout;	//!< the layout for the chunk vertex buffers.
+	};
+
+	/* \struct TilemapStats
+	*  \brief Counters for the last draw of a tilemap.
+	*/
+	struct TilemapStats
+	{
+		uint32_t chunksDrawn = 0;		//!< chunks that overlapped the view and had tiles in them.
+		uint32_t chunksRebuilt = 0;		//!< chunks baked this draw, either for the first time or because a tile changed.
+		uint32_t tilesDrawn = 0;		//!< tiles in the chunks drawn.
+	};
+
+	/* \class Tilemap
+	*  \brief A grid of tiles drawn from a tileset texture. The map is split into chunks of chunkSize x chunkSize tiles, each baked into its own static
+	*  vertex buffer the first time it is seen and only rebuilt when one of its tiles changes. Only chunks overlapping the view are touched, so the cost of a
+	*  draw depends on the view, not on the size of the map. Draw outside a Renderer2D scene, it uses its own shader and texture unit 0.
+	*/
+	class Tilemap
+	{
+	public:
+		Tilemap(uint32_t width, uint32_t height, float tileSize, const std::shared_ptr<Textures>& tileset, uint32_t tilesetColumns, uint32_t tilesetRows);	//!< constructor; map size in tiles, tile size in world units, and the tileset grid.
+		void setTile(uint32_t x, uint32_t y, uint16_t tile);	//!< set a tile; 0 is empty, n is the nth cell of the tileset (left to right, top to bottom, from 1).
+		uint16_t getTile(uint32_t x, uint32_t y) const;		//!< get a tile.
+		void draw(const SceneWideUniforms& swu, const glm::vec2& viewMin, const glm::vec2& viewMax);	//!< draw every chunk overlapping the view rectangle, baking any that need it.
+		inline const TilemapStats& getStats() const { return m_stats; }	//!< accessor for the counters of the last draw.
+
+		constexpr static uint32_t chunkSize = 32;	//!< width and height of a chunk in tiles.
+	private:
+		struct Chunk
+		{
+			std::shared_ptr<VertexArray> VAO;		//!< vertex array for the chunk, made when first baked.
+			std::shared_ptr<VertexBuffer> VBO;		//!< static vertex buffer, sized for a full chunk.
+			uint32_t tileCount = 0;					//!< number of non empty tiles baked.
+			bool dirty = true;						//!< needs (re)baking before it is drawn.
+		};	//!< a square of tiles drawn with one draw call.
+
+		void bake(uint32_t chunkX, uint32_t chunkY);	//!< rebuild the vertices of a chunk from its tiles.
+
+		uint32_t m_width;						//!< width of the map in tiles.
+		uint32_t m_height;						//!< height of the map in tiles.
+		float m_tileSize;						//!< size of a tile in world units.
+		std::shared_ptr<Textures> m_tileset;	//!< texture the tiles come from.
+		uint32_t m_tilesetColumns;				//!< tiles across the tileset.
+		uint32_t m_tilesetRows;					//!< tiles down the tileset.
+		std::vector<uint16_t> m_tiles;			//!< every tile, row by row.
+		uint32_t m_chunksX;						//!< chunks across the map.
+		uint32_t m_chunksY;						//!< chunks down the map.
+		std::vector<Chunk> m_chunks;			//!< every chunk, row by row.
+		std::vector<TilemapVertex> m_bakeBuffer;	//!< CPU side vertices of the chunk being baked.
+		std::shared_ptr<IndexBuffer> m_IBO;		//!< indices for a full chunk, shared by every chunk.
+		std::shared_ptr<Shaders> m_shader;		//!< the tilemap shader.
+		UniformHandle<float> m_tileSizeUniform;			//!< u_tileSize in the tilemap shader.
+		UniformHandle<int> m_tilesetUniform;			//!< u_tileset in the tilemap shader.
+		UniformHandle<glm::vec2> m_chunkOriginUniform;	//!< u_chunkOrigin in the tilemap shader, set per chunk.
+		TilemapStats m_stats;					//!< counters for the last draw.
+	};
+}
@@ -0,0 +1,105 @@
+/** \file blockLayout.h */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	/*	\enum BlockRules
+	*	\brief The GLSL layout rules a block is laid out by; std140 for uniform blocks, std430 for storage blocks that ask for it.
+	*/
+	enum class BlockRules { Std140, Std430 };
+
+	/*	\struct BlockArray
+	*	\brief Stands for a GLSL array of count T's in a block description.
+	*/
+	template<typename T, uint32_t count> struct BlockArray {};
+
+	/*	\struct BlockStruct
+	*	\brief Stands for a GLSL struct with these members, in order, in a block description.
+	*/
+	template<typename... Members> struct BlockStruct {};
+
+	/*	\struct BlockType
+	*	\brief Base alignment and size in bytes of a GLSL type under a set of rules. glm types stand for their GLSL namesakes; a mat3 is three
+	*	vec3 columns, each padded to a vec4, under both rules.
+	*/
+	template<typename T, BlockRules Rules> struct BlockType;
+	template<BlockRules Rules> struct BlockType<float, Rules> { constexpr static uint32_t alignment = 4, size = 4; };			//!< float.
+	template<BlockRules Rules> struct BlockType<int32_t, Rules> { constexpr static uint32_t alignment = 4, size = 4; };			//!< int.
+	template<BlockRules Rules> struct BlockType<uint32_t, Rules> { constexpr static uint32_t alignment = 4, size = 4; };		//!< uint.
+	template<BlockRules Rules> struct BlockType<glm::vec2, Rules> { constexpr static uint32_t alignment = 8, size = 8; };		//!< vec2.
+	template<BlockRules Rules> struct BlockType<glm::ivec2, Rules> { constexpr static uint32_t alignment = 8, size = 8; };		//!< ivec2.
+	template<BlockRules Rules> struct BlockType<glm::vec3, Rules> { constexpr static uint32_t alignment = 16, size = 12; };		//!< vec3; aligned like a vec4, but a scalar can follow in its last 4 bytes.
+	template<BlockRules Rules> struct BlockType<glm::ivec3, Rules> { constexpr static uint32_t alignment = 16, size = 12; };	//!< ivec3.
+	template<BlockRules Rules> struct BlockType<glm::vec4, Rules> { constexpr static uint32_t alignment = 16, size = 16; };		//!< vec4.
+	template<BlockRules Rules> struct BlockType<glm::ivec4, Rules> { constexpr static uint32_t alignment = 16, size = 16; };	//!< ivec4.
+	template<BlockRules Rules> struct BlockType<glm::mat3, Rules> { constexpr static uint32_t alignment = 16, size = 48; };		//!< mat3.
+	template<BlockRules Rules> struct BlockType<glm::mat4, Rules> { constexpr static uint32_t alignment = 16, size = 64; };		//!< mat4.
+
+	namespace BlockLayoutDetail
+	{
+		constexpr uint32_t roundUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) / alignment * alignment; }	//!< the next multiple of alignment.
+		constexpr uint32_t ruleAlignment(uint32_t alignment, BlockRules rules) { return rules == BlockRules::Std140 ? roundUp(alignment, 16) : alignment; }	//!< std140 rounds arrays and structs up to a vec4.
+	}
+
+	/*	\struct BlockLayout
+	*	\brief A block laid out at compile time from the GLSL types of its members. Describe the block, then static_assert the C++ struct that is
+	*	copied into it against the offsets and size here, so a mismatch fails the build instead of uploading garbage:
+	*	  using Lighting = BlockLayout<BlockRules::Std140, glm::vec3, glm::vec3, glm::vec3>;
+	*	  static_assert(offsetof(LightingBlock, viewPos) == Lighting::offset<1> && sizeof(LightingBlock) == Lighting::size, "");
+	*/
+	template<BlockRules Rules, typename... Members>
+	struct BlockLayout
+	{
+		static_assert(sizeof...(Members) > 0, "a block needs at least one member");
+	private:
+		constexpr static std::array<uint32_t, sizeof...(Members) + 1> layOut()
+		{
+			constexpr uint32_t alignments[] = { BlockType<Members, Rules>::alignment... };
+			constexpr uint32_t sizes[] = { BlockType<Members, Rules>::size... };
+			std::array<uint32_t, sizeof...(Members) + 1> offsets{};
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < sizeof...(Members); i++)
+			{
+				offset = BlockLayoutDetail::roundUp(offset, alignments[i]);
+				offsets[i] = offset;
+				offset += sizes[i];
+			}
+			offsets[sizeof...(Members)] = offset;
+			return offsets;
+		}	//!< the offset of each member, then where the last one ends.
+
+		constexpr static uint32_t largestAlignment()
+		{
+			uint32_t largest = 0;
+			for (uint32_t alignment : { BlockType<Members, Rules>::alignment... })
+				largest = alignment > largest ? alignment : largest;
+			return largest;
+		}	//!< the largest base alignment of any member.
+
+		constexpr static std::array<uint32_t, sizeof...(Members) + 1> s_offsets = layOut();	//!< the offset of each member, then where the last one ends.
+	public:
+		template<uint32_t index> constexpr static uint32_t offset = s_offsets[index];	//!< byte offset of a member.
+		constexpr static uint32_t alignment = BlockLayoutDetail::ruleAlignment(largestAlignment(), Rules);	//!< base alignment of the block used as a struct.
+		constexpr static uint32_t size = BlockLayoutDetail::roundUp(s_offsets[sizeof...(Members)], alignment);	//!< bytes it takes, padded at the end to its alignment; also its stride in an array.
+	};
+
+	template<typename T, uint32_t count, BlockRules Rules>
+	struct BlockType<BlockArray<T, count>, Rules>
+	{
+		constexpr static uint32_t alignment = BlockLayoutDetail::ruleAlignment(BlockType<T, Rules>::alignment, Rules);	//!< element alignment, rounded up to a vec4 under std140.
+		constexpr static uint32_t stride = BlockLayoutDetail::roundUp(BlockType<T, Rules>::size, alignment);			//!< bytes from one element to the next.
+		constexpr static uint32_t size = stride * count;																	//!< every element, padding included.
+	};	//!< an array.
+
+	template<typename... Members, BlockRules Rules>
+	struct BlockType<BlockStruct<Members...>, Rules>
+	{
+		constexpr static uint32_t alignment = BlockLayout<Rules, Members...>::alignment;	//!< its largest member's, rounded up to a vec4 under std140.
+		constexpr static uint32_t size = BlockLayout<Rules, Members...>::size;			//!< padded at the end to its alignment.
+	};	//!< a struct.
+}
\ No newline at end of file
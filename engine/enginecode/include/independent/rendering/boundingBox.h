@@ -0,0 +1,66 @@
+/** \file boundingBox.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cfloat>
+#include <cstring>
+#include "rendering/bufferLayout.h"
+
+namespace Engine
+{
+	/* \struct AABB
+	*  \brief An axis aligned bounding box. Starts empty (min above max) so growing it by the first point sets it.
+	*/
+	struct AABB
+	{
+		glm::vec3 min = glm::vec3(FLT_MAX);		//!< smallest corner.
+		glm::vec3 max = glm::vec3(-FLT_MAX);	//!< largest corner.
+
+		inline bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }	//!< false until something has been added.
+		inline glm::vec3 getCentre() const { return (min + max) * 0.5f; }		//!< the centre.
+		inline glm::vec3 getExtents() const { return (max - min) * 0.5f; }	//!< half the size on each axis.
+		inline void grow(const glm::vec3& point) { min = glm::min(min, point); max = glm::max(max, point); }	//!< grow to take in a point.
+		inline void grow(const AABB& other) { min = glm::min(min, other.min); max = glm::max(max, other.max); }	//!< grow to take in another box.
+		inline bool contains(const AABB& other) const
+		{
+			return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+				max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+		}	//!< whether another box is entirely inside this one.
+		inline float getSurfaceArea() const
+		{
+			glm::vec3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}	//!< surface area, the cost the AABB tree balances on.
+
+		inline AABB transformed(const glm::mat4& transform) const
+		{
+			//the box around the transformed box; the extents go through the absolute rotation and scale (Arvo).
+			glm::vec3 centre = glm::vec3(transform * glm::vec4(getCentre(), 1.0f));
+			glm::vec3 halfSize = getExtents();
+			glm::vec3 extents = glm::abs(glm::vec3(transform[0])) * halfSize.x + glm::abs(glm::vec3(transform[1])) * halfSize.y + glm::abs(glm::vec3(transform[2])) * halfSize.z;
+
+			AABB result;
+			result.min = centre - extents;
+			result.max = centre + extents;
+			return result;
+		}	//!< the world space box around this one once transformed.
+
+		static AABB fromVertices(const void* vertices, uint32_t vertexCount, const VertexBufferLayout& layout)
+		{
+			//positions are the first element of every 3D vertex format; anything else (2D, packed formats) has no bounds.
+			AABB bounds;
+			auto position = layout.begin();
+			if (!vertices || position == layout.end() || position->m_dataType != ShaderDataType::Float3)
+				return bounds;
+
+			const unsigned char* bytes = static_cast<const unsigned char*>(vertices) + position->m_offset;
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				glm::vec3 point;
+				memcpy(&point, bytes + i * layout.getStride(), sizeof(glm::vec3));
+				bounds.grow(point);
+			}
+			return bounds;
+		}	//!< scan the position attribute of a run of vertices.
+	};
+}
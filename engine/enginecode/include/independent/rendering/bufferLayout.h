@@ -37,14 +37,16 @@ namespace Engine
 		ShaderDataType m_dataType;		//!< what type of data is this element (float, int etc)
 		uint32_t m_size;				//!< int for the size.
 		uint32_t m_offset;				//!< int for the length of the offset.
+		uint32_t m_alignment;			//!< std140 base alignment; the offset is rounded up to it.
 		const char *m_name;				//!< name so we can search for it.
 
 		UniformBufferElement() {};		//!< default constructor.
 		UniformBufferElement(const char * name, ShaderDataType dataType) :
-			m_name(name),
 			m_dataType(dataType),
 			m_size(SDT::std140align(dataType)),
-			m_offset(0)
+			m_offset(0),
+			m_alignment(SDT::std140BaseAlignment(dataType)),
+			m_name(name)
 		{} //!< constructor with params. Takes name and dataType; with initialisor list linked to above vars (offset init to 0 as this will need calculating).
 	private:
 
@@ -58,13 +60,16 @@ namespace Engine
 	{
 	public:
 		BufferLayout<G>() {};		//!< default constructor.
-		BufferLayout<G>(const std::initializer_list<G>& element, uint32_t stride = 0) :
+		BufferLayout<G>(const std::initializer_list<G>& element, uint32_t stride = 0, uint32_t divisor = 0) :
 			m_elements(element),
-			m_stride(stride)
+			m_stride(stride),
+			m_divisor(divisor)
 		{
 			calculateStrideAndOffset();
-		}							//!< constructor with params, returns the calculation of stride and offset.
+		}							//!< constructor with params, returns the calculation of stride and offset. A divisor of 0 steps per vertex, n steps once every n instances.
 		inline uint32_t getStride() const { return m_stride; }		//!< get the length of the stride.
+		inline uint32_t getDivisor() const { return m_divisor; }	//!< get how many instances share each line of the buffer, 0 if per vertex.
+		inline void setDivisor(uint32_t divisor) { m_divisor = divisor; }	//!< set how many instances share each line of the buffer.
 		void addBufferElement(G element);							//!< add a buffer element.
 		inline typename std::vector<G>::iterator begin() { return m_elements.begin(); }				//!< begin, taking first element.
 		inline typename std::vector<G>::iterator end() { return m_elements.end(); }					//!< end, taking last element.
@@ -73,6 +78,7 @@ namespace Engine
 	private:
 		std::vector<G> m_elements;				//!< buffer elements.
 		uint32_t m_stride;						//!< width in bytes of a buffer line.
+		uint32_t m_divisor = 0;					//!< instances per buffer line; 0 means the buffer is per vertex.
 		void calculateStrideAndOffset();		//!< calculate the stride and offset based on the elements. 
 	}; 
 
@@ -115,6 +121,25 @@ namespace Engine
 			m_stride = l_offset;
 		}
 	}
+	template <>
+	inline void BufferLayout<UniformBufferElement>::calculateStrideAndOffset()
+	{
+		//std140; each element starts on its base alignment, and the block is padded to a vec4.
+		//the layout is only worked out here at runtime to look fields up by name, blocks copied whole should check theirs with BlockLayout.
+		uint32_t l_offset = 0;
+		for (auto& element : m_elements)
+		{
+			l_offset = (l_offset + element.m_alignment - 1) / element.m_alignment * element.m_alignment;
+			element.m_offset = l_offset;
+			l_offset += element.m_size;
+		}
+
+		if (m_stride == 0)
+		{
+			m_stride = (l_offset + 15) / 16 * 16;
+		}
+	}
+
 	using VertexBufferLayout = BufferLayout<VertexBufferElement>;	//type alias whenever use VertexBufferLayout this what is meant.
 	using UniformBufferLayout = BufferLayout<UniformBufferElement>;	//type alias whenever use UniformBufferLayout this what is meant.
 }
@@ -13,6 +13,7 @@ namespace Engine
 		virtual ~IndexBuffer() = default;					//!< virtual destructor.
 		virtual inline uint32_t getID() const = 0;			//!< virtual function to get and return the renderer ID.
 		virtual inline uint32_t getCount() const = 0;		//!< virtual function to get and return the count.
-		static IndexBuffer* create(uint32_t* indices, uint32_t count);		//!< please note, function declared in renderAPI.cpp
+		virtual void edit(const uint32_t* indices, uint32_t count, uint32_t offset) = 0;	//!< virtual function to overwrite count indices, starting offset indices in.
+		static IndexBuffer* create(uint32_t* indices, uint32_t count);		//!< indices can be nullptr to fill later with edit. Please note, function declared in renderAPI.cpp
 	};
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+/** \file ringBuffer.h */
+#pragma once
+
+#include <cstdint>
+
+namespace Engine
+{
+	/* \class RingBuffer
+	*  \brief API agnostic class for a buffer the CPU writes straight into every frame. It is split into sections, one per frame in flight; a frame
+	*  writes into its own section while the GPU reads the ones before it, so nothing has to wait unless the CPU gets a whole ring ahead.
+	*/
+	class RingBuffer
+	{
+	public:
+		virtual ~RingBuffer() = default;				//!< destructor.
+		virtual uint32_t getID() const = 0;				//!< accessor for the renderer ID.
+		virtual void beginFrame() = 0;					//!< move to the next section, waiting if the GPU is still reading it.
+		virtual void* allocate(uint32_t size, uint32_t& offset) = 0;	//!< space in this frame's section, aligned for binding; the offset is from the start of the buffer. nullptr if the section is full.
+		virtual void endFrame() = 0;					//!< mark the end of the GPU commands that read this frame's section.
+		virtual uint32_t getFrameSize() const = 0;		//!< accessor for the size of each section in bytes.
+		static RingBuffer* create(uint32_t frameSize, uint32_t frameCount = 3);	//!< create function, frameSize bytes per section. Please note, function declared in renderAPI.cpp
+	};
+}
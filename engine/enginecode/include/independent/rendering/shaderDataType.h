@@ -65,11 +65,11 @@ namespace Engine
 		{
 			switch (type)
 			{
-			case ShaderDataType::Mat3:   return 4 * 3 * 3;	//size of a mat3 is 36 bytes.
+			case ShaderDataType::Mat3:   return 4 * 4 * 3;	//3 columns, each padded to 4 floats, is 48 bytes.
 			case ShaderDataType::Mat4:   return 4 * 4 * 4;	//size of a mat4 is 64 bytes.
 			case ShaderDataType::Float:  return 4;			//size of a float is 4 bytes.
 			case ShaderDataType::Float2: return 4 * 2;		//2 floats is 8 bytes.
-			case ShaderDataType::Float3: return 4 * 4;		//4 floats is 16 bytes.  4! not 3, to do with alignment, must be aligned to N2 or N4.
+			case ShaderDataType::Float3: return 4 * 3;		//3 floats is 12 bytes; it starts on 16 (see std140BaseAlignment), but a scalar can follow in the last 4.
 			case ShaderDataType::Float4: return 4 * 4;		//4 floats is 16 bytes.
 			case ShaderDataType::Short:  return 2;			//size of a short is 2 bytes.
 			case ShaderDataType::Short2: return 2 * 2;		//2 floats is 4 bytes.
@@ -77,8 +77,22 @@ namespace Engine
 			case ShaderDataType::Short4: return 2 * 4;		//4 floats is 8 bytes.
 			case ShaderDataType::Byte2:  return 1 * 2;		//2 bytes.
 			case ShaderDataType::Byte4:  return 1 * 4;		//4 bytes.
+			case ShaderDataType::Int:    return 4;			//4 bytes.
 			default: return 0;
 			}
 		}
+
+		static uint32_t std140BaseAlignment(ShaderDataType type)
+		{
+			switch (type)
+			{
+			case ShaderDataType::Float2: return 4 * 2;		//a vec2 starts on 8 bytes.
+			case ShaderDataType::Float3:
+			case ShaderDataType::Float4:
+			case ShaderDataType::Mat3:
+			case ShaderDataType::Mat4:   return 4 * 4;		//vec3s, vec4s and matrix columns start on 16 bytes.
+			default: return std140align(type);				//scalars start on their own size.
+			}
+		}
 	}
 }
@@ -0,0 +1,25 @@
+/** \file shaderPreprocessor.h */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+	/** \class ShaderPreprocessor
+	*	\brief Text level work on shader sources before they are handed to the API: #include "file" is replaced by the file, found relative to
+	*	the one including it, and #defines are put in after every #version line, so one file can build several specialised variants.
+	*	Includes aren't guarded; a file meant to go in twice has to use #ifndef itself, as in C. An include of a file already being included is an error.
+	*/
+	class ShaderPreprocessor
+	{
+	public:
+		static bool load(const char* filePath, std::string& source);	//!< read a file with its includes resolved; false, reported, if any file can't be read.
+		static std::string addDefines(const std::string& source, const std::vector<std::string>& defines);	//!< the source with "#define <define>" after every #version line; a define can be "NAME" or "NAME VALUE".
+
+		constexpr static uint32_t maxIncludeDepth = 16;	//!< how deep includes can nest.
+	private:
+		static bool append(const std::string& filePath, std::string& source, std::vector<std::string>& including);	//!< add a file to the source, resolving its includes; including is the chain of files above it.
+	};
+}
\ No newline at end of file
@@ -2,10 +2,68 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
+#include "rendering/shaderDataType.h"
 
 namespace Engine
 {
+	class StorageBuffer;
+	class Textures;
+
+	/** \class UniformHandle
+	*	\brief A uniform looked up once and kept by the caller, so uploads through it skip the name lookup. Typed by what is uploaded through it,
+	*	and only means anything to the shader it came from. An invalid handle (the uniform isn't active, or is a different type) uploads nothing.
+	*/
+	template<typename T>
+	class UniformHandle
+	{
+	public:
+		UniformHandle() = default;											//!< default constructor, invalid.
+		explicit UniformHandle(int32_t location) : m_location(location) {}	//!< constructor with the location in the shader.
+		inline int32_t getLocation() const { return m_location; }			//!< accessor for the location.
+		inline bool isValid() const { return m_location >= 0; }			//!< whether the uniform was found.
+	private:
+		int32_t m_location = -1;	//!< location in the shader, -1 if not found.
+	};
+
+	/*	\struct UniformType
+	*	\brief Maps the C++ type of a handle to the shader data type it has to match.
+	*/
+	template<typename T> struct UniformType;
+	template<> struct UniformType<int> { constexpr static ShaderDataType type = ShaderDataType::Int; };			//!< ints and samplers.
+	template<> struct UniformType<float> { constexpr static ShaderDataType type = ShaderDataType::Float; };		//!< float.
+	template<> struct UniformType<glm::vec2> { constexpr static ShaderDataType type = ShaderDataType::Float2; };	//!< vec2.
+	template<> struct UniformType<glm::vec3> { constexpr static ShaderDataType type = ShaderDataType::Float3; };	//!< vec3.
+	template<> struct UniformType<glm::vec4> { constexpr static ShaderDataType type = ShaderDataType::Float4; };	//!< vec4.
+	template<> struct UniformType<glm::mat3> { constexpr static ShaderDataType type = ShaderDataType::Mat3; };	//!< mat3.
+	template<> struct UniformType<glm::mat4> { constexpr static ShaderDataType type = ShaderDataType::Mat4; };	//!< mat4.
+
+	/*	\enum ShaderStatus
+	*	\brief Where a shader is in being built; one made with createAsync is Compiling until the driver has linked it.
+	*/
+	enum class ShaderStatus { Compiling, Ready, Failed };
+
+	/*	\enum ImageAccess
+	*	\brief How a compute shader uses an image bound to it.
+	*/
+	enum class ImageAccess { Read, Write, ReadWrite };
+
+	/*	\struct ComputeBarrier
+	*	\brief What a dispatch's writes are used as afterwards; only those uses wait for it to finish.
+	*/
+	struct ComputeBarrier
+	{
+		constexpr static uint32_t storage = 1 << 0;		//!< storage buffers read by later shaders.
+		constexpr static uint32_t image = 1 << 1;		//!< images read by later shaders.
+		constexpr static uint32_t texture = 1 << 2;		//!< images sampled as textures.
+		constexpr static uint32_t vertex = 1 << 3;		//!< buffers read as vertex or index data.
+		constexpr static uint32_t command = 1 << 4;		//!< buffers read as indirect draw commands.
+		constexpr static uint32_t all = 0x1F;			//!< all of the above.
+	};
+
 	/** \class Shaders
 	*	\brief A class for an API agnostic shaders.
 	*/
@@ -14,16 +72,39 @@ namespace Engine
 	public:
 		virtual ~Shaders() = default;					//!< destructor.
 		virtual uint32_t getID() const = 0;				//!< gets and returns the renderer ID.
+		virtual ShaderStatus getStatus() = 0;			//!< whether it has finished building, without waiting for it; errors are logged the first time it is seen to have failed.
+		inline bool isReady() { return getStatus() == ShaderStatus::Ready; }	//!< whether it can be drawn with.
+		virtual void wait() = 0;						//!< block until it has finished building.
+		virtual bool isCompute() const = 0;				//!< whether it is a compute program, dispatched rather than drawn with.
+		virtual glm::uvec3 getWorkGroupSize() = 0;		//!< local size a compute shader declared, to work out how many groups cover the work; 0s for anything else.
 		 
 		virtual void uploadInt(const char* name, int value) = 0;					//!< uploading a texture (just an int) 
+		virtual void uploadIntArray(const char* name, int32_t* values, uint32_t count) = 0;	//!< upload an array of ints, such as a sampler array.
 		virtual void uploadFloat(const char* name, float value) = 0;				//!< upload single float.
 		virtual void uploadFloat2(const char* name, const glm::vec2& value) = 0;	//!< upload 2 float combination.
 		virtual void uploadFloat3(const char* name, const glm::vec3& value) = 0;	//!< upload 3 float combination.
 		virtual void uploadFloat4(const char* name, const glm::vec4& value) = 0;	//!< upload 4 float combination.
 		virtual void uploadMat4(const char* name, const glm::mat4& value) = 0;		//!< upload model matrices.
 
+		template<typename T> UniformHandle<T> getUniform(const char* name) { return UniformHandle<T>(getUniformLocation(name, UniformType<T>::type)); }	//!< look a uniform up once to upload through later.
+		virtual int32_t getUniformLocation(const char* name, ShaderDataType type) = 0;	//!< location of an active uniform of that type; -1 and reported (once per name) if there isn't one.
+		virtual void upload(UniformHandle<int> handle, int value) = 0;							//!< upload an int or sampler unit.
+		virtual void upload(UniformHandle<int> handle, const int32_t* values, uint32_t count) = 0;	//!< upload an int array.
+		virtual void upload(UniformHandle<float> handle, float value) = 0;						//!< upload a float.
+		virtual void upload(UniformHandle<glm::vec2> handle, const glm::vec2& value) = 0;		//!< upload a vec2.
+		virtual void upload(UniformHandle<glm::vec3> handle, const glm::vec3& value) = 0;		//!< upload a vec3.
+		virtual void upload(UniformHandle<glm::vec4> handle, const glm::vec4& value) = 0;		//!< upload a vec4.
+		virtual void upload(UniformHandle<glm::mat3> handle, const glm::mat3& value) = 0;		//!< upload a mat3.
+		virtual void upload(UniformHandle<glm::mat4> handle, const glm::mat4& value) = 0;		//!< upload a mat4.
+
+		virtual void bindStorageBuffer(uint32_t binding, const std::shared_ptr<StorageBuffer>& buffer) = 0;	//!< bind a buffer to a storage block binding for the next dispatch or draw.
+		virtual void bindImage(uint32_t unit, const std::shared_ptr<Textures>& texture, ImageAccess access) = 0;	//!< bind a texture's first level to an image unit; 1 or 4 channel textures only.
+		virtual void dispatch(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1, uint32_t barriers = ComputeBarrier::all) = 0;	//!< run a compute shader over that many work groups; barriers are what its writes are used as next.
+
 		static Shaders* create(const char* vertexFilePath, const char* fragmentFilePath);	//!< constructor, takes the filepaths for text files; NOTE declared renderAPI.cpp.
-		static Shaders* create(const char* filePath);	//!< constructor, takes a single file path, can put all shaders into a single file; NOTE declared renderAPI.cpp.
+		static Shaders* create(const char* filePath, const std::vector<std::string>& defines = {});	//!< constructor, takes a single file path, can put all shaders into a single file; the defines are added to every region, for a variant; NOTE declared renderAPI.cpp.
+		static Shaders* createAsync(const char* vertexFilePath, const char* fragmentFilePath);	//!< as create, but returns as soon as every stage is handed to the driver; poll getStatus before drawing with it; NOTE declared renderAPI.cpp.
+		static Shaders* createAsync(const char* filePath, const std::vector<std::string>& defines = {});	//!< as create, but returns as soon as every stage is handed to the driver; poll getStatus before drawing with it; NOTE declared renderAPI.cpp.
 
 	private:
 
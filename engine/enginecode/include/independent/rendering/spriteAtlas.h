@@ -0,0 +1,94 @@
+/** \file spriteAtlas.h */
+#pragma once
+
+#include "rendering/subTexture.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Engine
+{
+	/* \struct Sprite
+	*  \brief A sprite within an atlas; the sub texture plus what was trimmed off it, so it can still be placed as the original image.
+	*/
+	struct Sprite
+	{
+		SubTexture subTexture;					//!< where the (trimmed) sprite is in its page.
+		glm::ivec2 sourceSize = glm::ivec2(0);	//!< size of the original image in pixels.
+		glm::ivec2 trimOffset = glm::ivec2(0);	//!< top left of the trimmed rectangle within the original image.
+		glm::ivec2 trimSize = glm::ivec2(0);	//!< size of the trimmed rectangle; same as the source size if not trimmed.
+	};
+
+	/* \class SpriteAtlas
+	*  \brief A set of atlas pages and the sprites packed into them, looked up by name.
+	*/
+	class SpriteAtlas
+	{
+	public:
+		static std::shared_ptr<SpriteAtlas> load(const char* filepath);	//!< load an atlas written by SpriteAtlasBuilder::write; nullptr if it can't be read.
+		const Sprite* getSprite(const std::string& name) const;		//!< find a sprite by name; nullptr if there isn't one.
+		inline uint32_t getPageCount() const { return m_pages.size(); }	//!< accessor for the number of pages.
+		inline std::shared_ptr<Textures> getPage(uint32_t index) const { return m_pages[index]; }	//!< accessor for a page texture.
+		inline uint32_t getSpriteCount() const { return m_sprites.size(); }	//!< accessor for the number of sprites.
+	private:
+		std::vector<std::shared_ptr<Textures>> m_pages;			//!< the page textures.
+		std::unordered_map<std::string, Sprite> m_sprites;		//!< the sprites by name.
+		friend class SpriteAtlasBuilder;						//!< the builder fills in the pages and sprites.
+	};
+
+	/* \struct SpriteAtlasSettings
+	*  \brief How SpriteAtlasBuilder packs.
+	*/
+	struct SpriteAtlasSettings
+	{
+		uint32_t pageSize = 2048;	//!< width and height of each page in pixels.
+		uint32_t padding = 2;		//!< empty pixels left between sprites so filtering doesn't bleed.
+		bool trim = false;			//!< cut fully transparent rows and columns off the edges of each image before packing.
+	};
+
+	/* \class SpriteAtlasBuilder
+	*  \brief Packs many images into as few pages as it can with MaxRects (best short side fit). build() only touches the CPU, so the result
+	*  can either be uploaded straight away or written out as page images and a metadata file to be loaded later.
+	*/
+	class SpriteAtlasBuilder
+	{
+	public:
+		SpriteAtlasBuilder(const SpriteAtlasSettings& settings = SpriteAtlasSettings());	//!< constructor with the packing settings.
+		void addImage(const std::string& name, const std::string& filepath);	//!< queue an image to be packed under a name; names with whitespace are reported and not queued.
+		bool build();				//!< load, trim and pack every queued image; the loading is spread across the job system. False if anything couldn't be loaded or fitted.
+		std::shared_ptr<SpriteAtlas> upload() const;	//!< create the page textures and sprites; needs the GL context, so main thread only.
+		bool write(const std::string& directory, const std::string& name) const;	//!< write each page as a png and the sprites to name.atlas, all in the directory.
+		inline uint32_t getPageCount() const { return m_pages.size(); }	//!< accessor for the number of pages built.
+	private:
+		struct Image
+		{
+			std::string name;					//!< the name the sprite is looked up by.
+			std::string filepath;				//!< where the image is loaded from.
+			std::vector<unsigned char> pixels;	//!< RGBA pixels, trimmed.
+			glm::ivec2 sourceSize = glm::ivec2(0);	//!< size before trimming.
+			glm::ivec2 trimOffset = glm::ivec2(0);	//!< top left of what was kept.
+			glm::ivec2 size = glm::ivec2(0);		//!< size after trimming.
+			uint32_t page = 0;					//!< page it was packed into.
+			glm::ivec2 position = glm::ivec2(0);	//!< top left within the page.
+		};	//!< an image going into the atlas.
+
+		struct Rect
+		{
+			int32_t x, y, width, height;	//!< position and size.
+		};	//!< a rectangle in a page.
+
+		struct Page
+		{
+			std::vector<Rect> freeRects;		//!< the maximal free rectangles still left.
+			std::vector<unsigned char> pixels;	//!< RGBA pixels of the page.
+		};	//!< a page being packed.
+
+		static void loadImage(Image& image, bool trim);		//!< load an image and trim it; only touches the image so can run on any thread.
+		bool insert(Page& page, int32_t width, int32_t height, glm::ivec2& position);	//!< MaxRects insert into a page; false if it doesn't fit.
+
+		SpriteAtlasSettings m_settings;		//!< how to pack.
+		std::vector<Image> m_images;		//!< everything queued or packed.
+		std::vector<Page> m_pages;			//!< the pages.
+	};
+}
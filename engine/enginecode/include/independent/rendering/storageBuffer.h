@@ -0,0 +1,19 @@
+/** \file storageBuffer.h */
+#pragma once
+#include <cstdint>
+
+namespace Engine
+{
+	/** \class StorageBuffer
+	*	\brief A class for an API agnostic shader storage buffer; plain bytes that shaders index into, edited in place.
+	*/
+	class StorageBuffer
+	{
+	public:
+		virtual ~StorageBuffer() = default;					//!< virtual destructor.
+		virtual inline uint32_t getID() const = 0;			//!< virtual function to get and return the renderer ID.
+		virtual inline uint32_t getSize() const = 0;		//!< virtual function to get and return the size in bytes.
+		virtual void edit(const void* data, uint32_t size, uint32_t offset) = 0;	//!< virtual function to overwrite size bytes, starting offset bytes in.
+		static StorageBuffer* create(const void* data, uint32_t size);		//!< data can be nullptr to fill later with edit. Please note, function declared in renderAPI.cpp
+	};
+}
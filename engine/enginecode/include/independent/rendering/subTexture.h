@@ -1,7 +1,7 @@
 /** \file subTexture.h */
 #pragma once
 
-#include "platform/OpenGL/OpenGLTexture.h"
+#include "rendering/textures.h"
 #include <memory>
 #include <glm/glm.hpp>
 
@@ -14,10 +14,11 @@ namespace Engine
 	{
 	public:
 		SubTexture() {};		//!< default constructor.
-		SubTexture(const std::shared_ptr<OpenGLTexture>& texture, const glm::vec2& UVStart, const glm::vec2& UVEnd);	//!< specialised constructor; with shared_ptr to a texture, vec2 for UV start of sub texture and UV end for the end of the sub texture.
+		SubTexture(const std::shared_ptr<Textures>& texture, const glm::vec2& UVStart, const glm::vec2& UVEnd);	//!< specialised constructor; with shared_ptr to a texture, vec2 for UV start of sub texture and UV end for the end of the sub texture.
 		
-		inline glm::vec2 getUVStart() { return m_UVStart; }		//!< accessor to return UV start data.
-		inline glm::vec2 getUVEnd() { return m_UVEnd; }			//!< accessor to return UV end data.
+		inline glm::vec2 getUVStart() const { return m_UVStart; }		//!< accessor to return UV start data.
+		inline glm::vec2 getUVEnd() const { return m_UVEnd; }			//!< accessor to return UV end data.
+		inline std::shared_ptr<Textures> getBaseTexture() const { return m_texture; }	//!< accessor to return the texture (atlas) this is part of.
 		inline glm::ivec2 getTextureSize() { return m_size; }	//!< accessor to return pixel size of texture.
 		glm::vec2 getTextureSizeF() { return { static_cast<float>(m_size.x), static_cast<float>(m_size.y) }; }			//!< returns a float version of m_size, useful for when doing some maths with this.
 	
@@ -31,7 +32,7 @@ namespace Engine
 		glm::vec2 transformUV(glm::vec2 UV);	//!< transform the original to the atlas-ed coordinates, this for both U & V (x & y); used for linear interpolation.
 
 	private:
-		std::shared_ptr<OpenGLTexture> m_texture;		//!< will hold and store texture.
+		std::shared_ptr<Textures> m_texture;		//!< will hold and store texture.
 		glm::vec2 m_UVStart;		//!< will hold and store UV start data.
 		glm::vec2 m_UVEnd;			//!< will hold and store UV end data.
 		glm::ivec2 m_size;			//!< store size in pixels.
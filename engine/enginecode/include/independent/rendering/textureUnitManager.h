@@ -17,6 +17,8 @@ namespace Engine
 		{}														//!< constructor taking the capacity of the ring buffer.
 		~TextureUnitManager() {};								//!< destructor.
 		inline bool isFull() { return m_capacityFull; };		//!< accessor for whether ring buffer is full.
+		inline uint32_t getCapacity() { return m_capacity; }	//!< accessor for the capacity of the ring buffer.
+		bool isBound(uint32_t textureID);						//!< returns whether the texture is already held in a unit of the ring buffer.
 		void clear();											//!< clear the ring buffer.
 		bool getUnit(uint32_t textureID, uint32_t& textureUnit);//!< returns whether the texture needs to be binded to the unit; false=do not need to bind, true=we do need to bind. Texture unit always set to unit.
 	private:
@@ -2,14 +2,35 @@
 #pragma once
 #include <ctype.h>
 #include <memory>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "rendering/bufferLayout.h"
 #include "rendering/shaders.h"
+#include "systems/log.h"
 
 namespace Engine
 {
+	/** \class UniformBlockField
+	*	\brief A field of a uniform block looked up once and kept by the caller, so setting it skips the name lookup. Typed by what is set through
+	*	it, and only means anything to the buffer it came from. An invalid field (no such name, or a different type) sets nothing.
+	*/
+	template<typename T>
+	class UniformBlockField
+	{
+	public:
+		UniformBlockField() = default;											//!< default constructor, invalid.
+		explicit UniformBlockField(int32_t offset) : m_offset(offset) {}		//!< constructor with the offset in the block.
+		inline int32_t getOffset() const { return m_offset; }					//!< accessor for the offset.
+		inline bool isValid() const { return m_offset >= 0; }					//!< whether the field was found.
+	private:
+		int32_t m_offset = -1;	//!< offset in the block in bytes, -1 if not found.
+	};
+
 	/* \class UniformBuffer
-	*  \brief API agnostic class to create, set and attah the appropriate uniform buffer.
+	*  \brief API agnostic class to create, set and attah the appropriate uniform buffer. Fields are set in a CPU copy of the block, and only
+	*  set ones that changed are marked dirty; upload() then sends the dirty range in one go, so a block costs at most one upload a frame.
 	*/
 	class UniformBuffer
 	{
@@ -18,11 +39,55 @@ namespace Engine
 		virtual uint32_t getID() = 0;					//!< accessor for openGL ID.
 		virtual UniformBufferLayout getLayout() = 0;	//!< accessor for the uniform buffer layout.
 		virtual void attachShaderBlock(const std::shared_ptr<Shaders>& shader, const char* blockName) = 0;	//!< get shader and attach to requested block.
-		virtual void uploadDataToBlock(const char* uniformName, void* data) = 0;		//!< send data to the block.
+		virtual void upload() = 0;						//!< send whatever has changed since the last upload, if anything.
+		void uploadDataToBlock(const char* uniformName, const void* data);	//!< set a field by name, from as many bytes as it takes up; sent on the next upload().
+
+		template<typename T> UniformBlockField<T> getField(const char* name);	//!< look a field up once to set through later; invalid and reported if there isn't one of that type.
+		template<typename T> void set(UniformBlockField<T> field, const T& value) { if (field.isValid()) writeField(field.getOffset(), UniformType<T>::type, &value); }	//!< set a field; sent on the next upload().
+		template<typename Block> void setBlock(const Block& block);	//!< copy a whole struct over the block; check the struct against a BlockLayout first. Sent on the next upload().
+
 		static UniformBuffer* create(const UniformBufferLayout& layout);				//!< create function, a little like a constructor. Please note, function declared in renderAPI.cpp
 	protected:
+		struct FieldInfo
+		{
+			uint32_t offset;			//!< where it starts in the block.
+			uint32_t size;				//!< bytes it takes up.
+			ShaderDataType type;		//!< what it was declared as.
+		};	//!< a field of the block.
+
+		void initialiseShadow();		//!< fill the field table from the layout and size the CPU copy to it; called by the constructor.
+		void write(uint32_t offset, const void* data, uint32_t size);	//!< copy into the CPU copy, growing the dirty range only if the bytes differ.
+		void writeField(uint32_t offset, ShaderDataType type, const void* data);	//!< copy a packed value of a type into the CPU copy as std140 lays it out; a mat3's columns go 16 bytes apart.
+
 		UniformBufferLayout m_BufferLayout;				//!< uniform bugger layout.
 		uint32_t m_blockNumber;							//!< block number for this uniform buffer layout.
-		std::unordered_map<const char*, std::pair<uint32_t, uint32_t>> m_uniformCache;			//!< stores the uniform names, including sizes and offsets.
+		std::unordered_map<std::string, FieldInfo> m_uniformCache;			//!< stores the uniform names, including sizes and offsets; by value, so any copy of a name finds it.
+		std::vector<unsigned char> m_shadow;			//!< CPU copy of the block.
+		uint32_t m_dirtyBegin = 0xFFFFFFFF;				//!< first byte changed since the last upload.
+		uint32_t m_dirtyEnd = 0;						//!< one past the last; nothing to upload when it isn't past m_dirtyBegin.
 	};
+
+	template<typename Block>
+	void UniformBuffer::setBlock(const Block & block)
+	{
+		static_assert(std::is_trivially_copyable<Block>::value, "a block is copied byte for byte");
+		if (sizeof(Block) > m_shadow.size())
+		{
+			Log::error("Uniform block {0} is {1} bytes, too small for a {2} byte struct", m_blockNumber, m_shadow.size(), sizeof(Block));
+			return;
+		}
+		write(0, &block, sizeof(Block));
+	}
+
+	template<typename T>
+	UniformBlockField<T> UniformBuffer::getField(const char * name)
+	{
+		auto it = m_uniformCache.find(name);
+		if (it == m_uniformCache.end() || it->second.type != UniformType<T>::type || it->second.size < sizeof(T))
+		{
+			Log::error("Uniform block {0} has no field {1} of that type", m_blockNumber, name);
+			return UniformBlockField<T>();
+		}
+		return UniformBlockField<T>(it->second.offset);
+	}
 }
\ No newline at end of file
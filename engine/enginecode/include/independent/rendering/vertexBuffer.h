@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include "rendering/bufferLayout.h"
+#include "rendering/boundingBox.h"
 
 namespace Engine
 {
@@ -16,6 +17,7 @@ namespace Engine
 		virtual void edit(void* vertices, uint32_t size, uint32_t offset) = 0;	//!< virtual to edit function, to edit the vertex buffer.
 		virtual inline uint32_t getID() const = 0;								//!< virtual to gets and returns the renderer ID.
 		virtual inline const VertexBufferLayout& const getLayout() = 0;			//!< virtual to gets and returns the buffer layout.
+		virtual inline const AABB& getBounds() const = 0;						//!< virtual to get the bounds of the positions, found when the vertices are given; invalid if the layout doesn't start with a Float3 position.
 
 		static VertexBuffer* create(void* vertices, uint32_t size, const VertexBufferLayout& layout);	//!< please note, function declared in renderAPI.cpp
 
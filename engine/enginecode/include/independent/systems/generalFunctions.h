@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include <array>
+#include <cstddef>
 
 namespace Engine
 {
@@ -14,11 +15,15 @@ namespace Engine
 	public:
 		static std::array<int16_t, 3> normalise(const glm::vec3& norm);		//!< normalise vec3
 		static std::array<int16_t, 2> normalise(const glm::vec2& uv);		//!< normalise vec2
-		uint32_t package(const glm::vec4& colour);						//!< package vec4
-		uint32_t package(const glm::vec3& colour)	
+		static uint32_t package(const glm::vec4& colour);				//!< package vec4
+		static uint32_t package(const glm::vec3& colour)	
 		{
 			return package({ colour.x, colour.y, colour.z, 1.0f });
 		}																//!< package vec3
+		static uint64_t hash(const void* data, size_t size, uint64_t seed = hashSeed);	//!< 64 bit FNV-1a of some bytes, carrying on from seed so several can be hashed together.
+		static uint64_t hash(const char* string, uint64_t seed = hashSeed);				//!< hash of a string and its length, so consecutive strings can't run into each other; nullptr counts as empty.
+
+		constexpr static uint64_t hashSeed = 0xCBF29CE484222325ull;	//!< where a hash starts.
 	private:
 
 	};
@@ -0,0 +1,37 @@
+/** \file jobSystem.h */
+#pragma once
+
+#include "system.h"
+#include <functional>
+#include <future>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace Engine
+{
+	/*	\class JobSystem
+	*	\brief System owning a pool of worker threads that jobs can be handed to. If the system hasn't been started jobs just run on the calling thread.
+	*/
+	class JobSystem : public System
+	{
+	public:
+		virtual void start(SystemSignal init = SystemSignal::None, ...) override;	//!< start the worker threads, one less than the hardware threads as the main thread works too.
+		virtual void stop(SystemSignal close = SystemSignal::None, ...) override;	//!< finish the queued jobs and join the worker threads.
+
+		static std::future<void> submit(const std::function<void(void)>& job);	//!< queue a job for the workers; the future is ready once it has run.
+		static void parallelFor(uint32_t count, const std::function<void(uint32_t, uint32_t)>& job);	//!< split [0, count) into ranges across the workers and the calling thread, returns once every range is done.
+		inline static uint32_t getWorkerCount() { return s_workers.size(); }	//!< accessor for the number of worker threads.
+
+	private:
+		static void workerLoop();		//!< what each worker runs; takes jobs off the queue until stopped.
+
+		static std::vector<std::thread> s_workers;					//!< the worker threads.
+		static std::queue<std::packaged_task<void(void)>> s_jobs;	//!< jobs waiting for a worker.
+		static std::mutex s_mutex;									//!< guards the job queue.
+		static std::condition_variable s_condition;					//!< wakes workers when there is a job or when stopping.
+		static bool s_running;										//!< whether the workers should keep going.
+	};
+}
@@ -14,6 +14,7 @@ namespace Engine
 		virtual ~OpenGLIndexBuffer();								//!< destructor.
 		virtual inline uint32_t getID() const override { return m_OpenGL_ID; }		//!< gets and returns the renderer ID.
 		virtual inline uint32_t getCount() const override { return m_count; }		//!< gets and returns the count.
+		virtual void edit(const uint32_t* indices, uint32_t count, uint32_t offset) override;	//!< overwrite count indices, starting offset indices in.
 	private:
 		uint32_t m_OpenGL_ID;		//!< OpenGL render identifier 
 		uint32_t m_count;			//!< the draw count.
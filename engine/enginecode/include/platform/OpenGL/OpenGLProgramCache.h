@@ -0,0 +1,39 @@
+/** \file OpenGLProgramCache.h */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+	/* \class OpenGLProgramCache
+	*  \brief Linked programs saved to disk with glGetProgramBinary and loaded back with glProgramBinary, so shaders only compile the first run.
+	*  Entries are keyed by a hash of every stage's source together with the GL vendor, renderer and version, so a change to either a shader or
+	*  the driver misses and the program is compiled and saved again. A binary the driver won't take is treated as a miss too.
+	*/
+	class OpenGLProgramCache
+	{
+	public:
+		static uint64_t makeKey(const std::vector<const char*>& sources);	//!< the key for a program built from these sources on this driver.
+		static bool load(uint32_t program, uint64_t key);		//!< give the program the cached binary for the key; false if there isn't one or it doesn't link.
+		static void store(uint32_t program, uint64_t key);		//!< save a linked program's binary under the key; it has to have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+		static void setDirectory(const std::string& directory) { s_directory = directory; }	//!< where the binaries go; "shaderCache" by default, relative to the working directory.
+		static bool isSupported();								//!< whether the driver has any program binary formats.
+	private:
+		struct FileHeader
+		{
+			uint32_t magic;				//!< marks the file as a program binary.
+			uint32_t version;			//!< layout of this header.
+			uint64_t key;				//!< the full key, in case two keys share a file name.
+			uint32_t format;			//!< the driver's binary format.
+			uint32_t size;				//!< bytes of binary after the header.
+		};	//!< what starts each cache file.
+
+		static std::string getPath(uint64_t key);				//!< the file for a key.
+
+		static std::string s_directory;							//!< where the binaries go.
+		constexpr static uint32_t s_magic = 0x4250474E;			//!< "NGPB".
+		constexpr static uint32_t s_version = 1;				//!< bump when FileHeader changes.
+	};
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+/** \file OpenGLRingBuffer.h */
+#pragma once
+
+#include "rendering/ringBuffer.h"
+#include <vector>
+
+typedef struct __GLsync *GLsync;
+
+namespace Engine
+{
+	/* \class OpenGLRingBuffer
+	*  \brief OpenGL specific ring buffer; persistently and coherently mapped, so writes need no flush or unmap, with a fence per section.
+	*/
+	class OpenGLRingBuffer : public RingBuffer
+	{
+	public:
+		OpenGLRingBuffer(uint32_t frameSize, uint32_t frameCount);	//!< constructor.
+		virtual ~OpenGLRingBuffer();								//!< destructor.
+		inline uint32_t getID() const override { return m_OpenGL_ID; }	//!< accessor for openGL ID.
+		void beginFrame() override;									//!< move to the next section, waiting on its fence.
+		void* allocate(uint32_t size, uint32_t& offset) override;	//!< space in this frame's section.
+		void endFrame() override;									//!< fence this frame's section.
+		inline uint32_t getFrameSize() const override { return m_frameSize; }	//!< accessor for the section size.
+	private:
+		uint32_t m_OpenGL_ID;				//!< OpenGL ID.
+		unsigned char* m_mapped;			//!< the whole buffer, mapped for as long as it lives.
+		uint32_t m_frameSize;				//!< bytes per section.
+		uint32_t m_alignment;				//!< offsets handed out are multiples of this, so they can be bound as uniform or storage ranges.
+		uint32_t m_frame = 0;				//!< section being written.
+		uint32_t m_used = 0;				//!< bytes used in it.
+		std::vector<GLsync> m_fences;		//!< fence per section, null if nothing is reading it.
+	};
+}
@@ -2,6 +2,10 @@
 #pragma once
 
 #include "rendering/shaders.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace Engine
 {
@@ -11,20 +15,79 @@ namespace Engine
 	class OpenGLShader : public Shaders
 	{
 	public:
-		OpenGLShader(const char* vertexFilePath, const char* fragmentFilePath);	//!< constructor, takes the filepaths for text files.
-		OpenGLShader(const char* filePath);										//!< constructor, takes a single file path, can put all shaders into a single file.
+		OpenGLShader(const char* vertexFilePath, const char* fragmentFilePath, bool async = false);	//!< constructor, takes the filepaths for text files; async returns once the stages are submitted.
+		OpenGLShader(const char* filePath, const std::vector<std::string>& defines = {}, bool async = false);	//!< constructor, takes a single file path, can put all shaders into a single file; every region present is compiled, a Compute region on its own makes a compute program. The defines go in after each #version; async returns once the stages are submitted.
 		virtual ~OpenGLShader();												//!< destructor.
 		virtual uint32_t getID() const { return m_OpenGL_ID; };					//!< gets and returns the renderer ID.
+		virtual ShaderStatus getStatus() override;								//!< polls GL_COMPLETION_STATUS_KHR where the driver has it, otherwise finishes the link there and then.
+		virtual void wait() override;											//!< finish the link, blocking on the driver if it isn't done.
+		virtual bool isCompute() const override { return m_isCompute; }		//!< whether it is a compute program.
+		virtual glm::uvec3 getWorkGroupSize() override;							//!< GL_COMPUTE_WORK_GROUP_SIZE.
 		 
 		virtual void uploadInt(const char* name, int value) override;					//!< uploading a texture (just an int) 
+		virtual void uploadIntArray(const char* name, int32_t* values, uint32_t count) override;	//!< upload an array of ints, such as a sampler array.
 		virtual void uploadFloat(const char* name, float value) override;				//!< upload single float.
 		virtual void uploadFloat2(const char* name, const glm::vec2& value) override;	//!< upload 2 float combination.
 		virtual void uploadFloat3(const char* name, const glm::vec3& value) override;	//!< upload 3 float combination.
 		virtual void uploadFloat4(const char* name, const glm::vec4& value) override;	//!< upload 4 float combination.
 		virtual void uploadMat4(const char* name, const glm::mat4& value) override;		//!< upload model matrices.
 
+		virtual int32_t getUniformLocation(const char* name, ShaderDataType type) override;	//!< location of an active uniform of that type from the reflected table; -1 and reported once if there isn't one.
+		virtual void upload(UniformHandle<int> handle, int value) override;							//!< upload an int or sampler unit.
+		virtual void upload(UniformHandle<int> handle, const int32_t* values, uint32_t count) override;	//!< upload an int array.
+		virtual void upload(UniformHandle<float> handle, float value) override;						//!< upload a float.
+		virtual void upload(UniformHandle<glm::vec2> handle, const glm::vec2& value) override;		//!< upload a vec2.
+		virtual void upload(UniformHandle<glm::vec3> handle, const glm::vec3& value) override;		//!< upload a vec3.
+		virtual void upload(UniformHandle<glm::vec4> handle, const glm::vec4& value) override;		//!< upload a vec4.
+		virtual void upload(UniformHandle<glm::mat3> handle, const glm::mat3& value) override;		//!< upload a mat3.
+		virtual void upload(UniformHandle<glm::mat4> handle, const glm::mat4& value) override;		//!< upload a mat4.
+		int32_t getUniformBlockIndex(const char* name);		//!< index of an active uniform block; -1 and reported once if there isn't one.
+
+		virtual void bindStorageBuffer(uint32_t binding, const std::shared_ptr<StorageBuffer>& buffer) override;	//!< glBindBufferRange to GL_SHADER_STORAGE_BUFFER over the whole buffer.
+		virtual void bindImage(uint32_t unit, const std::shared_ptr<Textures>& texture, ImageAccess access) override;	//!< glBindImageTexture, as R8 or RGBA8 by the texture's channels.
+		virtual void dispatch(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1, uint32_t barriers = ComputeBarrier::all) override;	//!< glDispatchCompute, then glMemoryBarrier for the barriers asked for.
+		static bool hasExtension(const char* name);	//!< whether the driver lists a GL or GLSL extension, for shaders that need one.
+
 	private:
-		uint32_t m_OpenGL_ID;		//!< OpenGL render identifier. 
-		void compileAndLink(const char* vertexShaderScr, const char* fragmentShaderScr);		//!< compiles and links shaders, just the two at the moment.
+		struct StageSource
+		{
+			uint32_t type;			//!< the GL shader type.
+			const char* name;		//!< the stage's name, for errors.
+			const char* source;		//!< its source.
+		};	//!< a stage to compile.
+
+		struct Stage
+		{
+			uint32_t shader;		//!< the compiled shader object.
+			const char* name;		//!< the stage's name, for errors.
+		};	//!< a stage attached while the link is pending.
+
+		struct UniformInfo
+		{
+			int32_t location;		//!< location to upload to.
+			ShaderDataType type;	//!< type it was declared as; samplers are Int, anything else unsupported is None.
+			int32_t arraySize;		//!< elements, 1 if not an array.
+		};	//!< an active uniform outside any block.
+
+		struct UniformBlockInfo
+		{
+			int32_t index;			//!< block index for glUniformBlockBinding.
+			int32_t dataSize;		//!< bytes the block needs.
+		};	//!< an active uniform block.
+
+		uint32_t m_OpenGL_ID = 0;	//!< OpenGL render identifier. 
+		ShaderStatus m_status = ShaderStatus::Failed;	//!< where the build is; failed until something has been submitted.
+		std::vector<Stage> m_stages;	//!< compiled stages still attached while the link is pending.
+		bool m_isCompute = false;	//!< whether it is a compute program.
+		uint64_t m_cacheKey = 0;	//!< key the binary is saved under once linked.
+		std::unordered_map<std::string, UniformInfo> m_uniforms;			//!< active uniforms by name, arrays by their name without [0].
+		std::unordered_map<std::string, UniformBlockInfo> m_uniformBlocks;	//!< active uniform blocks by name.
+		std::unordered_set<std::string> m_reported;							//!< names already reported missing or mistyped, so each is only reported once.
+		void reflect();				//!< fill the uniform and block tables from the linked program.
+		void reportOnce(const std::string& name, const char* problem);	//!< log a problem with a uniform name the first time it is seen.
+		void compileAndLink(const std::vector<StageSource>& stages, bool async);		//!< compiles and links every stage given; async leaves the link pending.
+		void submit(const std::vector<StageSource>& stages);	//!< hand every stage and the link to the driver without asking how they went.
+		void finish();				//!< check each stage and the link, report errors, and reflect and cache a program that linked.
+		static bool hasParallelCompile();	//!< whether the driver has KHR (or ARB) parallel_shader_compile, so completion can be polled.
 	};
 }
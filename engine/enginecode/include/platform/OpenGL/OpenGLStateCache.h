@@ -0,0 +1,76 @@
+/** \file OpenGLStateCache.h */
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+namespace Engine
+{
+	/* \struct OpenGLStateStats
+	*  \brief Counters of the state changes asked of the cache; issued went through to GL, skipped matched what was already bound.
+	*/
+	struct OpenGLStateStats
+	{
+		uint32_t issued = 0;	//!< calls that reached GL.
+		uint32_t skipped = 0;	//!< calls dropped as redundant.
+	};
+
+	/* \class OpenGLStateCache
+	*  \brief Shadow of the GL binding and enable state, so asking for what is already bound costs nothing. Everything that binds a program, texture,
+	*  VAO or buffer, or toggles depth test and blending, goes through here; a raw GL call behind its back leaves the shadow wrong, so call invalidate()
+	*  after any code that doesn't. Element array buffers are VAO state and aren't shadowed, binds of them always go through.
+	*/
+	class OpenGLStateCache
+	{
+	public:
+		static void useProgram(uint32_t program);						//!< glUseProgram.
+		static void bindTextureUnit(uint32_t unit, uint32_t texture);	//!< glBindTextureUnit.
+		static void bindTexture2D(uint32_t texture);					//!< glBindTexture to GL_TEXTURE_2D on unit 0, the only active unit the engine uses; needed for textures not made with glCreateTextures.
+		static void bindVertexArray(uint32_t VAO);						//!< glBindVertexArray.
+		static void bindBuffer(uint32_t target, uint32_t buffer);		//!< glBindBuffer.
+		static void bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, uint32_t offset, uint32_t size);	//!< glBindBufferRange; always issued, but the generic binding it also sets is kept track of.
+		static void setEnabled(uint32_t capability, bool enabled);		//!< glEnable or glDisable.
+		static void blendFunc(uint32_t source, uint32_t destination);	//!< glBlendFunc.
+		static void clearColour(float r, float g, float b, float a);	//!< glClearColor.
+
+		static void onProgramDeleted(uint32_t program);		//!< forget a program before its name can be reused.
+		static void onTextureDeleted(uint32_t texture);		//!< forget a texture on every unit it is bound to.
+		static void onVertexArrayDeleted(uint32_t VAO);		//!< forget a VAO.
+		static void onBufferDeleted(uint32_t buffer);		//!< forget a buffer on every target it is bound to.
+		static void invalidate();							//!< forget everything, so the next call of each kind is issued.
+
+		static void endFrame();		//!< keep this frame's counters and start the next; called as the buffers are swapped.
+		inline static const OpenGLStateStats& getStats() { return s_stats; }			//!< accessor for the counters of the frame so far.
+		inline static const OpenGLStateStats& getFrameStats() { return s_frameStats; }	//!< accessor for the counters of the last whole frame.
+
+		constexpr static uint32_t maxTextureUnits = 32;	//!< texture units shadowed; binds to units above this always go through.
+	private:
+		constexpr static uint32_t s_unknown = 0xFFFFFFFF;	//!< shadow value for state that hasn't been set through the cache yet.
+
+		struct BufferBinding
+		{
+			uint32_t target;	//!< the GL target.
+			uint32_t buffer;	//!< the buffer bound to it.
+		};	//!< a shadowed buffer target.
+
+		struct Capability
+		{
+			uint32_t capability;	//!< the GL capability.
+			bool enabled;			//!< whether it is on.
+		};	//!< a shadowed enable.
+
+		static bool record(bool redundant);		//!< count a call; true if it needs issuing.
+
+		static uint32_t s_program;										//!< current program.
+		static std::array<uint32_t, maxTextureUnits> s_textures;		//!< texture per unit.
+		static uint32_t s_VAO;											//!< current VAO.
+		static std::vector<BufferBinding> s_buffers;					//!< buffers per target, added as targets are first used.
+		static std::vector<Capability> s_capabilities;					//!< enables, added as capabilities are first used.
+		static std::array<uint32_t, 2> s_blendFunc;						//!< source and destination factors.
+		static std::array<float, 4> s_clearColour;						//!< clear colour.
+		static bool s_clearColourKnown;									//!< whether the clear colour has been set through the cache.
+		static OpenGLStateStats s_stats;								//!< counters for the frame so far.
+		static OpenGLStateStats s_frameStats;							//!< counters for the last whole frame.
+	};
+}
@@ -0,0 +1,22 @@
+/** \file OpenGLStorageBuffer.h */
+#pragma once
+#include "rendering/storageBuffer.h"
+
+namespace Engine
+{
+	/** \class OpenGLStorageBuffer
+	*	\brief OpenGL specific shader storage buffer.
+	*/
+	class OpenGLStorageBuffer : public StorageBuffer
+	{
+	public:
+		OpenGLStorageBuffer(const void* data, uint32_t size);		//!< constructor
+		virtual ~OpenGLStorageBuffer();								//!< destructor.
+		virtual inline uint32_t getID() const override { return m_OpenGL_ID; }		//!< gets and returns the renderer ID.
+		virtual inline uint32_t getSize() const override { return m_size; }		//!< gets and returns the size in bytes.
+		virtual void edit(const void* data, uint32_t size, uint32_t offset) override;	//!< overwrite size bytes, starting offset bytes in.
+	private:
+		uint32_t m_OpenGL_ID;		//!< OpenGL render identifier 
+		uint32_t m_size;			//!< size in bytes.
+	};
+}
@@ -16,7 +16,7 @@ namespace Engine
 		inline uint32_t getID() override { return m_OpenGL_ID; }					//!< accessor for openGL ID.
 		inline UniformBufferLayout getLayout() override { return m_BufferLayout; }	//!< accessor for the uniform buffer layout.
 		void attachShaderBlock(const std::shared_ptr<Shaders>& shader, const char* blockName) override;	//!< send data to the block.
-		void uploadDataToBlock(const char* uniformName, void * data) override;		//!< create function, a little like a constructor. Please note, function declared in renderAPI.cpp
+		void upload() override;														//!< one glNamedBufferSubData of the dirty range.
 	private:
 		uint32_t m_OpenGL_ID;					//!< OpenGL ID.
 		static uint32_t s_blockNumber;			//!< a global block number.
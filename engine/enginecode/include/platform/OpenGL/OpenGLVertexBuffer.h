@@ -16,9 +16,11 @@ namespace Engine
 		virtual void edit(void* vertices, uint32_t size, uint32_t offset) override;		//!< edit function, to edit the vertex buffer; same params as constructor. Don't need a BufferLayout as that will be set, will need a uint32_t offset to place the buffer.
 		virtual inline uint32_t getID() const override { return m_OpenGL_ID; }	//!< gets and returns the renderer ID.
 		virtual inline VertexBufferLayout& const getLayout() override { return m_layout; }	//!< gets and returns the buffer layout
+		virtual inline const AABB& getBounds() const override { return m_bounds; }		//!< gets the bounds of the positions written so far.
 
 	private:
 		uint32_t m_OpenGL_ID;		//!< OpenGL render identifier 
 		VertexBufferLayout m_layout;		//!< buffer layout
+		AABB m_bounds;						//!< bounds of the positions, grown by each edit.
 	};
 }
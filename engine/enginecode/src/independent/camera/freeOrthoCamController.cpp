@@ -4,6 +4,7 @@
 #include "camera/freeOrthoCamController.h"
 #include "core/inputPoller.h"
 #include "events/codes.h"
+#include <cfloat>
 
 namespace Engine
 {
@@ -52,6 +53,22 @@ namespace Engine
 		m_camera.view = glm::inverse(glm::translate(glm::mat4(1.0f), m_position) * glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation), { 0.0f, 0.0f, 1.0f }));
 	}
 
+	void FreeOthroCamController::getViewBounds(glm::vec2 & min, glm::vec2 & max) const
+	{
+		//take the corners of clip space back into the world.
+		glm::mat4 clipToWorld = glm::inverse(m_camera.projection * m_camera.view);
+		glm::vec2 corners[4] = { { -1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f } };
+
+		min = glm::vec2(FLT_MAX);
+		max = glm::vec2(-FLT_MAX);
+		for (const auto& corner : corners)
+		{
+			glm::vec4 world = clipToWorld * glm::vec4(corner, 0.0f, 1.0f);
+			min = glm::min(min, glm::vec2(world));
+			max = glm::max(max, glm::vec2(world));
+		}
+	}
+
 	void FreeOthroCamController::onEvent(Event & event)
 	{
 		//for resize of window.
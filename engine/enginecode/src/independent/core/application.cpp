@@ -58,6 +58,10 @@ namespace Engine {
 		m_ranNumSytem.reset(new RandomNumberGenerator);
 		m_ranNumSytem->start();
 
+		//start the job system.
+		m_jobSystem.reset(new JobSystem);
+		m_jobSystem->start();
+
 		//calling function that binds all the callbacks for the event types.
 		bindAllEventsTypes();
 
@@ -179,6 +183,7 @@ namespace Engine {
 	Application::~Application()
 	{
 		//stop the systems in the REVERSE ORDER to how they start.
+		m_jobSystem->stop();
 		m_ranNumSytem->stop();
 		m_windowsSystem->stop();
 		m_logSystem->stop();
@@ -319,8 +324,8 @@ namespace Engine {
 #pragma endregion
 
 #pragma region SHADERS
-		std::shared_ptr<Shaders> TPShader;
-		TPShader.reset(Shaders::create("assets/shaders/texturedPhong.glsl"));
+		//a variant per material flag combination, each compiled while the rest loads; Renderer3D starts drawing with them once they have linked.
+		std::shared_ptr<ShaderVariants> TPVariants = std::make_shared<ShaderVariants>("assets/shaders/texturedPhong.glsl");
 #pragma endregion 
 
 #pragma region TEXTURES
@@ -352,9 +357,9 @@ namespace Engine {
 		TextureTypeStruct textureStructNumber;
 		textureStructNumber.diffuseTexture = numberTexture;
 
-		pyramidMaterial.reset(new Material(TPShader, textureStructPyramid, { 0.3f, 0.9f, 0.4f, 1.0f }));
-		letterCubeMaterial.reset(new Material(TPShader, textureStructLetter));
-		numberCubeMaterial.reset(new Material(TPShader, textureStructNumber));
+		pyramidMaterial.reset(new Material(TPVariants, textureStructPyramid, { 0.3f, 0.9f, 0.4f, 1.0f }));
+		letterCubeMaterial.reset(new Material(TPVariants, textureStructLetter));
+		numberCubeMaterial.reset(new Material(TPVariants, textureStructNumber));
 #pragma endregion
 		
 #pragma region CAMERAS_LIGHTS_ACTION!
@@ -428,11 +433,15 @@ namespace Engine {
 		float timeStep = 0.0f;
 
 		//initiate 2D renderer.
-		Renderer2D::init();
+		Renderer2D::init(TextMode::SDF);
 
-		//initiate 3D renderer & attach shaders.
+		//initiate 3D renderer; the shaders are set up as the materials pick their variants.
 		Renderer3D::init();
-		Renderer3D::attachShader(TPShader);
+
+		//bake the materials; the handles are all a submit needs.
+		MaterialHandle pyramidMaterialHandle = Renderer3D::createMaterial(*pyramidMaterial);
+		MaterialHandle letterCubeMaterialHandle = Renderer3D::createMaterial(*letterCubeMaterial);
+		MaterialHandle numberCubeMaterialHandle = Renderer3D::createMaterial(*numberCubeMaterial);
 
 		while (m_running)
 		{
@@ -452,10 +461,10 @@ namespace Engine {
 
 			//begin rendering with the scene wide uniforms. 
 			Renderer3D::begin(swu3D);
-			//submit renderer info with vertex array, material and mat4 model of object that needs to be drawn.
-			Renderer3D::submit(pyramidVAO, pyramidMaterial, models[0]);		
-			Renderer3D::submit(cubeVAO, numberCubeMaterial, models[1]);
-			Renderer3D::submit(cubeVAO, letterCubeMaterial, models[2]);
+			//submit renderer info with vertex array, material handle and mat4 model of object that needs to be drawn.
+			Renderer3D::submit(pyramidVAO, pyramidMaterialHandle, models[0]);		
+			Renderer3D::submit(cubeVAO, numberCubeMaterialHandle, models[1]);
+			Renderer3D::submit(cubeVAO, letterCubeMaterialHandle, models[2]);
 			//end the rendering.
 			Renderer3D::end();
 
@@ -475,6 +484,9 @@ namespace Engine {
 			
 			//disable blending.
 			RendererCommons::actionCommand(disableBlendCommand);
+
+			//every 2D scene this frame is done.
+			Renderer2D::endFrame();
 			
 			//updates on cameras.
 			cam2D.onUpdate(timeStep);
@@ -0,0 +1,284 @@
+/** \file aabbTree.cpp */
+
+#include "engine_pch.h"
+#include "renderer/aabbTree.h"
+#include <algorithm>
+
+namespace Engine
+{
+	namespace
+	{
+		AABB combine(const AABB& a, const AABB& b)
+		{
+			AABB result = a;
+			result.grow(b);
+			return result;
+		}
+	}
+
+	AABBTree::AABBTree(float margin) :
+		m_margin(margin)
+	{
+	}
+
+	int32_t AABBTree::insert(const AABB & bounds, uint32_t userData)
+	{
+		int32_t leaf = allocateNode();
+		m_nodes[leaf].bounds.min = bounds.min - glm::vec3(m_margin);
+		m_nodes[leaf].bounds.max = bounds.max + glm::vec3(m_margin);
+		m_nodes[leaf].userData = userData;
+		m_nodes[leaf].height = 0;
+		insertLeaf(leaf);
+		return leaf;
+	}
+
+	void AABBTree::remove(int32_t proxy)
+	{
+		removeLeaf(proxy);
+		freeNode(proxy);
+	}
+
+	bool AABBTree::update(int32_t proxy, const AABB & bounds)
+	{
+		//still inside the fat box, so the tree doesn't change.
+		if (m_nodes[proxy].bounds.contains(bounds))
+			return false;
+
+		removeLeaf(proxy);
+		m_nodes[proxy].bounds.min = bounds.min - glm::vec3(m_margin);
+		m_nodes[proxy].bounds.max = bounds.max + glm::vec3(m_margin);
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void AABBTree::query(const Frustum & frustum, std::vector<uint32_t>& results, AABBTreeQueryStats & stats) const
+	{
+		if (m_root == nullNode)
+			return;
+
+		std::vector<int32_t> stack;
+		stack.reserve(64);
+		stack.push_back(m_root);
+
+		while (!stack.empty())
+		{
+			int32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+
+			stats.nodesTested++;
+			FrustumTest result = frustum.test(node.bounds);
+			if (result == FrustumTest::Outside)
+				continue;
+
+			//everything below a box that is wholly inside is too, so there is nothing more to test.
+			if (result == FrustumTest::Inside || node.isLeaf())
+			{
+				size_t before = results.size();
+				collect(index, results);
+				stats.visible += results.size() - before;
+				continue;
+			}
+
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+
+	int32_t AABBTree::allocateNode()
+	{
+		if (m_freeList == nullNode)
+		{
+			m_nodes.push_back(Node());
+			m_freeList = m_nodes.size() - 1;
+			m_nodes[m_freeList].parent = nullNode;
+		}
+
+		int32_t node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+		m_nodes[node].parent = nullNode;
+		m_nodes[node].child1 = nullNode;
+		m_nodes[node].child2 = nullNode;
+		m_nodes[node].height = 0;
+		m_nodes[node].userData = 0;
+		return node;
+	}
+
+	void AABBTree::freeNode(int32_t node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	void AABBTree::insertLeaf(int32_t leaf)
+	{
+		if (m_root == nullNode)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = nullNode;
+			return;
+		}
+
+		//walk down towards the cheapest sibling; the cost of a branch is the area it would gain plus what its ancestors already gained.
+		//the leaf's box is copied, as allocating the new parent below can grow m_nodes and move it.
+		const AABB leafBounds = m_nodes[leaf].bounds;
+		int32_t index = m_root;
+		while (!m_nodes[index].isLeaf())
+		{
+			const Node& node = m_nodes[index];
+			float area = node.bounds.getSurfaceArea();
+			float combinedArea = combine(node.bounds, leafBounds).getSurfaceArea();
+
+			//making a new parent here.
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCost[2];
+			int32_t children[2] = { node.child1, node.child2 };
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				const Node& child = m_nodes[children[i]];
+				float grownArea = combine(child.bounds, leafBounds).getSurfaceArea();
+				childCost[i] = child.isLeaf() ? grownArea + inheritanceCost : (grownArea - child.bounds.getSurfaceArea()) + inheritanceCost;
+			}
+
+			if (cost < childCost[0] && cost < childCost[1])
+				break;
+
+			index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+		}
+
+		//a new parent for the sibling and the leaf, where the sibling was.
+		int32_t sibling = index;
+		int32_t oldParent = m_nodes[sibling].parent;
+		int32_t newParent = allocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].bounds = combine(leafBounds, m_nodes[sibling].bounds);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == nullNode)
+			m_root = newParent;
+		else if (m_nodes[oldParent].child1 == sibling)
+			m_nodes[oldParent].child1 = newParent;
+		else
+			m_nodes[oldParent].child2 = newParent;
+
+		refit(oldParent);
+	}
+
+	void AABBTree::removeLeaf(int32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = nullNode;
+			return;
+		}
+
+		//the sibling takes the parent's place.
+		int32_t parent = m_nodes[leaf].parent;
+		int32_t grandParent = m_nodes[parent].parent;
+		int32_t sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		if (grandParent == nullNode)
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = nullNode;
+			freeNode(parent);
+			return;
+		}
+
+		if (m_nodes[grandParent].child1 == parent)
+			m_nodes[grandParent].child1 = sibling;
+		else
+			m_nodes[grandParent].child2 = sibling;
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	}
+
+	void AABBTree::refit(int32_t node)
+	{
+		while (node != nullNode)
+		{
+			node = balance(node);
+
+			Node& current = m_nodes[node];
+			const Node& child1 = m_nodes[current.child1];
+			const Node& child2 = m_nodes[current.child2];
+			current.height = 1 + std::max(child1.height, child2.height);
+			current.bounds = combine(child1.bounds, child2.bounds);
+
+			node = current.parent;
+		}
+	}
+
+	int32_t AABBTree::balance(int32_t a)
+	{
+		Node& A = m_nodes[a];
+		if (A.isLeaf() || A.height < 2)
+			return a;
+
+		int32_t b = A.child1;
+		int32_t c = A.child2;
+		int32_t heightDifference = m_nodes[c].height - m_nodes[b].height;
+
+		//lift the taller child up into A's place, moving one of its children down to A.
+		if (heightDifference > 1 || heightDifference < -1)
+		{
+			int32_t up = (heightDifference > 1) ? c : b;
+			int32_t other = (heightDifference > 1) ? b : c;
+			Node& U = m_nodes[up];
+			int32_t f = U.child1;
+			int32_t g = U.child2;
+
+			U.child1 = a;
+			U.parent = A.parent;
+			A.parent = up;
+
+			if (U.parent == nullNode)
+				m_root = up;
+			else if (m_nodes[U.parent].child1 == a)
+				m_nodes[U.parent].child1 = up;
+			else
+				m_nodes[U.parent].child2 = up;
+
+			//the taller grandchild stays with U, the shorter goes to A.
+			int32_t keep = (m_nodes[f].height > m_nodes[g].height) ? f : g;
+			int32_t give = (keep == f) ? g : f;
+
+			U.child2 = keep;
+			if (heightDifference > 1)
+				A.child2 = give;
+			else
+				A.child1 = give;
+			m_nodes[give].parent = a;
+
+			A.bounds = combine(m_nodes[other].bounds, m_nodes[give].bounds);
+			A.height = 1 + std::max(m_nodes[other].height, m_nodes[give].height);
+			U.bounds = combine(A.bounds, m_nodes[keep].bounds);
+			U.height = 1 + std::max(A.height, m_nodes[keep].height);
+
+			return up;
+		}
+
+		return a;
+	}
+
+	void AABBTree::collect(int32_t node, std::vector<uint32_t>& results) const
+	{
+		if (m_nodes[node].isLeaf())
+		{
+			results.push_back(m_nodes[node].userData);
+			return;
+		}
+
+		collect(m_nodes[node].child1, results);
+		collect(m_nodes[node].child2, results);
+	}
+}
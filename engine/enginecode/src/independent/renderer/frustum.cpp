@@ -0,0 +1,85 @@
+/** \file frustum.cpp */
+
+#include "engine_pch.h"
+#include "renderer/frustum.h"
+#include <xmmintrin.h>
+
+namespace Engine
+{
+	Frustum::Frustum()
+	{
+		//no planes that cut anything.
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			m_normalX[i] = m_normalY[i] = m_normalZ[i] = 0.0f;
+			m_distance[i] = FLT_MAX;
+		}
+	}
+
+	Frustum::Frustum(const glm::mat4 & projectionView) : Frustum()
+	{
+		//glm is column major, so row i is projectionView[0][i] .. projectionView[3][i].
+		glm::vec4 row[4];
+		for (uint32_t i = 0; i < 4; i++)
+			row[i] = glm::vec4(projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i]);
+
+		glm::vec4 planes[6] =
+		{
+			row[3] + row[0],	//left.
+			row[3] - row[0],	//right.
+			row[3] + row[1],	//bottom.
+			row[3] - row[1],	//top.
+			row[3] + row[2],	//near.
+			row[3] - row[2]		//far.
+		};
+
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			//normalised, so the distances are true distances and the radius test is exact.
+			float length = glm::length(glm::vec3(planes[i]));
+			glm::vec4 plane = planes[i] / length;
+			m_normalX[i] = plane.x;
+			m_normalY[i] = plane.y;
+			m_normalZ[i] = plane.z;
+			m_distance[i] = plane.w;
+		}
+	}
+
+	FrustumTest Frustum::test(const AABB & box) const
+	{
+		glm::vec3 centre = box.getCentre();
+		glm::vec3 extents = box.getExtents();
+
+		__m128 centreX = _mm_set1_ps(centre.x);
+		__m128 centreY = _mm_set1_ps(centre.y);
+		__m128 centreZ = _mm_set1_ps(centre.z);
+		__m128 extentX = _mm_set1_ps(extents.x);
+		__m128 extentY = _mm_set1_ps(extents.y);
+		__m128 extentZ = _mm_set1_ps(extents.z);
+		__m128 signMask = _mm_set1_ps(-0.0f);
+
+		int outside = 0;
+		int intersecting = 0;
+		for (uint32_t i = 0; i < 8; i += 4)
+		{
+			__m128 normalX = _mm_load_ps(m_normalX + i);
+			__m128 normalY = _mm_load_ps(m_normalY + i);
+			__m128 normalZ = _mm_load_ps(m_normalZ + i);
+
+			//signed distance of the centre from each plane.
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, centreX), _mm_mul_ps(normalY, centreY)),
+				_mm_add_ps(_mm_mul_ps(normalZ, centreZ), _mm_load_ps(m_distance + i)));
+
+			//how far the box reaches along each normal.
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, normalX), extentX), _mm_mul_ps(_mm_andnot_ps(signMask, normalY), extentY)),
+				_mm_mul_ps(_mm_andnot_ps(signMask, normalZ), extentZ));
+
+			outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_xor_ps(radius, signMask)));
+			intersecting |= _mm_movemask_ps(_mm_cmplt_ps(distance, radius));
+		}
+
+		if (outside)
+			return FrustumTest::Outside;
+		return intersecting ? FrustumTest::Intersecting : FrustumTest::Inside;
+	}
+}
@@ -0,0 +1,104 @@
+/** \file geometryPool.cpp */
+
+#include "engine_pch.h"
+#include "renderer/geometryPool.h"
+#include "renderer/meshSimplifier.h"
+#include "systems/log.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace Engine
+{
+	GeometryPool::GeometryPool(const VertexBufferLayout & layout, uint32_t vertexCapacity, uint32_t indexCapacity) :
+		m_stride(layout.getStride()),
+		m_freeVertices(vertexCapacity),
+		m_freeIndices(indexCapacity)
+	{
+		m_VBO.reset(VertexBuffer::create(nullptr, vertexCapacity * m_stride, layout));
+		m_IBO.reset(IndexBuffer::create(nullptr, indexCapacity));
+		m_VAO.reset(VertexArray::create());
+		m_VAO->addVertexBuffer(m_VBO);
+		m_VAO->setIndexBuffer(m_IBO);
+	}
+
+	MeshRange GeometryPool::add(void * vertices, uint32_t vertexCount, const uint32_t * indices, uint32_t indexCount, uint32_t lodCount)
+	{
+		MeshRange mesh;
+		if (vertexCount == 0 || indexCount == 0)
+			return mesh;
+
+		mesh.bounds = AABB::fromVertices(vertices, vertexCount, m_VBO->getLayout());
+
+		//each LOD halves the last; it stops early once simplifying stops paying, around seams and borders that can't move.
+		std::vector<std::vector<uint32_t>> lodIndices(1, std::vector<uint32_t>(indices, indices + indexCount));
+		std::vector<float> lodErrors(1, 0.0f);
+		uint32_t totalIndices = indexCount;
+		lodCount = std::min(lodCount, MeshRange::maxLODs);
+		for (uint32_t lod = 1; lod < lodCount && mesh.bounds.isValid(); lod++)
+		{
+			const std::vector<uint32_t>& previous = lodIndices.back();
+			std::vector<uint32_t> simplified;
+			float error = MeshSimplifier::simplify(vertices, vertexCount, m_VBO->getLayout(), previous.data(), previous.size(), previous.size() / 6 * 3, FLT_MAX, simplified);
+			if (simplified.empty() || simplified.size() > previous.size() * 9 / 10)
+				break;
+
+			totalIndices += simplified.size();
+			lodIndices.push_back(std::move(simplified));
+			lodErrors.push_back(error);
+		}
+
+		if (!m_freeVertices.allocate(vertexCount, mesh.firstVertex))
+		{
+			Log::error("Geometry pool has no room for {0} vertices", vertexCount);
+			return mesh;
+		}
+
+		if (!m_freeIndices.allocate(totalIndices, mesh.firstIndex))
+		{
+			Log::error("Geometry pool has no room for {0} indices", totalIndices);
+			m_freeVertices.release(mesh.firstVertex, vertexCount);
+			return mesh;
+		}
+
+		mesh.vertexCount = vertexCount;
+		mesh.indexCount = indexCount;
+
+		m_VBO->edit(vertices, vertexCount * m_stride, mesh.firstVertex * m_stride);
+
+		//a LOD can be used once its error, scaled to the screen with the mesh, is below lodScreenError; never before the LOD above it.
+		float radius = glm::length(mesh.bounds.getExtents());
+		uint32_t firstIndex = mesh.firstIndex;
+		mesh.lodCount = lodIndices.size();
+		for (uint32_t lod = 0; lod < mesh.lodCount; lod++)
+		{
+			MeshLOD& level = mesh.lods[lod];
+			level.firstIndex = firstIndex;
+			level.indexCount = lodIndices[lod].size();
+			if (lod == 0)
+				level.screenSize = FLT_MAX;
+			else if (lodErrors[lod] <= 0.0f)
+				level.screenSize = mesh.lods[lod - 1].screenSize;
+			else
+				level.screenSize = std::min(lodScreenError * radius / lodErrors[lod], mesh.lods[lod - 1].screenSize);
+
+			m_IBO->edit(lodIndices[lod].data(), level.indexCount, firstIndex);
+			firstIndex += level.indexCount;
+		}
+
+		return mesh;
+	}
+
+	void GeometryPool::remove(const MeshRange & mesh)
+	{
+		if (!mesh.isValid())
+			return;
+
+		//the old data stays in the buffers, it just isn't drawn and will be overwritten.
+		uint32_t indexCount = 0;
+		for (uint32_t lod = 0; lod < mesh.lodCount; lod++)
+			indexCount += mesh.lods[lod].indexCount;
+
+		m_freeVertices.release(mesh.firstVertex, mesh.vertexCount);
+		m_freeIndices.release(mesh.firstIndex, indexCount);
+	}
+}
\ No newline at end of file
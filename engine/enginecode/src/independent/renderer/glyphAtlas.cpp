@@ -0,0 +1,273 @@
+/** \file glyphAtlas.cpp */
+
+#include "engine_pch.h"
+#include "renderer/glyphAtlas.h"
+#include "systems/log.h"
+#include "systems/jobSystem.h"
+#include <algorithm>
+
+namespace Engine
+{
+	namespace
+	{
+		constexpr float s_EDTInfinity = 1e20f;	//!< stands in for 'no feature pixel found yet' in the distance transform.
+
+		//one dimensional squared distance transform (Felzenszwalb & Huttenlocher), the lower envelope of parabolas rooted at each sample.
+		void distanceTransform1D(const float* f, float* d, uint32_t n, int32_t* v, float* z)
+		{
+			int32_t k = 0;
+			v[0] = 0;
+			z[0] = -s_EDTInfinity;
+			z[1] = s_EDTInfinity;
+
+			for (int32_t q = 1; q < static_cast<int32_t>(n); q++)
+			{
+				float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+				while (s <= z[k])
+				{
+					k--;
+					s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+				}
+				k++;
+				v[k] = q;
+				z[k] = s;
+				z[k + 1] = s_EDTInfinity;
+			}
+
+			k = 0;
+			for (int32_t q = 0; q < static_cast<int32_t>(n); q++)
+			{
+				while (z[k + 1] < q)
+					k++;
+				d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+			}
+		}
+
+		//two dimensional squared distance transform in place; columns then rows.
+		void distanceTransform2D(std::vector<float>& grid, uint32_t width, uint32_t height)
+		{
+			uint32_t n = std::max(width, height);
+			std::vector<float> f(n), d(n), z(n + 1);
+			std::vector<int32_t> v(n);
+
+			for (uint32_t x = 0; x < width; x++)
+			{
+				for (uint32_t y = 0; y < height; y++)
+					f[y] = grid[y * width + x];
+				distanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+				for (uint32_t y = 0; y < height; y++)
+					grid[y * width + x] = d[y];
+			}
+
+			for (uint32_t y = 0; y < height; y++)
+			{
+				distanceTransform1D(&grid[y * width], d.data(), width, v.data(), z.data());
+				memcpy(&grid[y * width], d.data(), width * sizeof(float));
+			}
+		}
+	}
+
+	GlyphAtlas::GlyphAtlas(uint32_t width, uint32_t height, uint32_t padding, GlyphMode mode, uint32_t spread) :
+		m_size(width, height),
+		m_padding(padding),
+		m_mode(mode),
+		m_spread(spread)
+	{
+		//start the atlas cleared, otherwise the padding between glyphs is whatever was in memory.
+		std::vector<unsigned char> clear(width * height, 0);
+		m_texture.reset(Textures::create(width, height, 1, clear.data()));
+	}
+
+	const GlyphInfo& GlyphAtlas::getGlyph(FT_Face face, uint32_t pixelSize, uint32_t codepoint)
+	{
+		GlyphKey key = { face, pixelSize, codepoint };
+
+		//already rasterised, nothing to do.
+		auto it = m_glyphs.find(key);
+		if (it != m_glyphs.end())
+			return it->second;
+
+		//first use; anything that fails is still cached (as an empty glyph) so freetype isn't asked again every frame.
+		RasterGlyph raster;
+		if (rasterise(face, pixelSize, codepoint, raster) && m_mode == GlyphMode::SDF)
+			generateSDF(raster);
+
+		return insert(key, raster);
+	}
+
+	void GlyphAtlas::prewarm(FT_Face face, uint32_t pixelSize, const std::vector<uint32_t>& codepoints)
+	{
+		std::vector<GlyphKey> keys;
+		std::vector<RasterGlyph> rasters;
+		keys.reserve(codepoints.size());
+		rasters.reserve(codepoints.size());
+
+		//freetype has to be driven from this thread.
+		for (uint32_t codepoint : codepoints)
+		{
+			GlyphKey key = { face, pixelSize, codepoint };
+			if (m_glyphs.find(key) != m_glyphs.end())
+				continue;
+
+			keys.push_back(key);
+			rasters.emplace_back();
+			rasterise(face, pixelSize, codepoint, rasters.back());
+		}
+
+		//the distance fields are the expensive part and each glyph is independent.
+		if (m_mode == GlyphMode::SDF)
+		{
+			JobSystem::parallelFor(rasters.size(), [this, &rasters](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+					generateSDF(rasters[i]);
+			});
+		}
+
+		//packing and uploading go back on this thread, it owns the GL context.
+		for (uint32_t i = 0; i < keys.size(); i++)
+			insert(keys[i], rasters[i]);
+	}
+
+	bool GlyphAtlas::rasterise(FT_Face face, uint32_t pixelSize, uint32_t codepoint, RasterGlyph & raster)
+	{
+		if (FT_Set_Pixel_Sizes(face, 0, pixelSize))
+		{
+			Log::error("ERROR: font size NOT set: {0}", pixelSize);
+			return false;
+		}
+
+		if (FT_Load_Char(face, codepoint, FT_LOAD_RENDER))
+		{
+			Log::error("Error: Freetype could NOT load the glyph for {0}", codepoint);
+			return false;
+		}
+
+		FT_GlyphSlot slot = face->glyph;
+		raster.width = slot->bitmap.width;
+		raster.height = slot->bitmap.rows;
+		raster.bearing = glm::vec2(slot->bitmap_left, -slot->bitmap_top);
+		raster.advance = static_cast<float>(slot->advance.x >> 6);
+
+		//copy the bitmap out row by row as the freetype pitch can be wider than the glyph.
+		raster.pixels.resize(raster.width * raster.height);
+		for (uint32_t row = 0; row < raster.height; row++)
+			memcpy(&raster.pixels[row * raster.width], slot->bitmap.buffer + row * slot->bitmap.pitch, raster.width);
+
+		return true;
+	}
+
+	void GlyphAtlas::generateSDF(RasterGlyph & raster) const
+	{
+		//spaces etc. have nothing to measure a distance to.
+		if (raster.width == 0 || raster.height == 0)
+			return;
+
+		//grow the glyph by the spread on each side so the field has room to fall off outside the edge.
+		uint32_t width = raster.width + m_spread * 2;
+		uint32_t height = raster.height + m_spread * 2;
+
+		//squared distance to the nearest inside pixel, and to the nearest outside pixel.
+		std::vector<float> toInside(width * height, s_EDTInfinity);
+		std::vector<float> toOutside(width * height, 0.0f);
+		for (uint32_t y = 0; y < raster.height; y++)
+		{
+			for (uint32_t x = 0; x < raster.width; x++)
+			{
+				if (raster.pixels[y * raster.width + x] >= 128)
+				{
+					uint32_t i = (y + m_spread) * width + x + m_spread;
+					toInside[i] = 0.0f;
+					toOutside[i] = s_EDTInfinity;
+				}
+			}
+		}
+
+		distanceTransform2D(toInside, width, height);
+		distanceTransform2D(toOutside, width, height);
+
+		//0.5 sits on the edge; 1 is a full spread inside, 0 a full spread outside.
+		raster.pixels.resize(width * height);
+		for (uint32_t i = 0; i < width * height; i++)
+		{
+			float signedDistance = sqrt(toOutside[i]) - sqrt(toInside[i]);
+			float value = 0.5f + signedDistance / (2.0f * m_spread);
+			raster.pixels[i] = static_cast<unsigned char>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+		}
+
+		raster.width = width;
+		raster.height = height;
+		raster.bearing -= glm::vec2(static_cast<float>(m_spread));
+	}
+
+	const GlyphInfo & GlyphAtlas::insert(const GlyphKey & key, const RasterGlyph & raster)
+	{
+		GlyphInfo& glyph = m_glyphs[key];
+		glyph.bearing = raster.bearing;
+		glyph.advance = raster.advance;
+
+		//spaces etc. have an advance but no bitmap.
+		if (raster.width == 0 || raster.height == 0)
+			return glyph;
+
+		glm::uvec2 position;
+		if (!allocate(raster.width, raster.height, position))
+		{
+			Log::error("Glyph atlas full, cannot fit glyph for {0}", key.codepoint);
+			return glyph;
+		}
+
+		//only the glyph's own rectangle goes to the GPU.
+		m_texture->edit(position.x, position.y, raster.width, raster.height, const_cast<unsigned char*>(raster.pixels.data()));
+
+		glyph.size = glm::vec2(raster.width, raster.height);
+		glyph.UVStart = glm::vec2(position.x / static_cast<float>(m_size.x), position.y / static_cast<float>(m_size.y));
+		glyph.UVEnd = glm::vec2((position.x + raster.width) / static_cast<float>(m_size.x), (position.y + raster.height) / static_cast<float>(m_size.y));
+
+		return glyph;
+	}
+
+	size_t GlyphAtlas::GlyphKeyHash::operator()(const GlyphKey & key) const
+	{
+		size_t hash = std::hash<void*>()(key.face);
+		hash ^= std::hash<uint32_t>()(key.pixelSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<uint32_t>()(key.codepoint) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	bool GlyphAtlas::allocate(uint32_t width, uint32_t height, glm::uvec2 & position)
+	{
+		uint32_t paddedWidth = width + m_padding;
+		uint32_t paddedHeight = height + m_padding;
+
+		if (paddedWidth > m_size.x)
+			return false;
+
+		//find the shortest shelf the glyph fits on.
+		Shelf* best = nullptr;
+		for (auto& shelf : m_shelves)
+		{
+			if (shelf.height >= paddedHeight && m_size.x - shelf.x >= paddedWidth)
+			{
+				if (!best || shelf.height < best->height)
+					best = &shelf;
+			}
+		}
+
+		//open a new shelf if nothing fits, or if the best fit would waste more than half its height.
+		uint32_t newShelfY = m_shelves.empty() ? 0 : m_shelves.back().y + m_shelves.back().height;
+		bool roomForShelf = newShelfY + paddedHeight <= m_size.y;
+		if (roomForShelf && (!best || best->height > paddedHeight * 2))
+		{
+			m_shelves.push_back({ newShelfY, paddedHeight, 0 });
+			best = &m_shelves.back();
+		}
+
+		if (!best)
+			return false;
+
+		position = glm::uvec2(best->x, best->y);
+		best->x += paddedWidth;
+		return true;
+	}
+}
@@ -0,0 +1,271 @@
+/** \file meshSimplifier.cpp */
+
+#include "engine_pch.h"
+#include "renderer/meshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Engine
+{
+	namespace
+	{
+		//sum of squared distances to a set of planes, as the symmetric 4x4 matrix of the plane equations; doubles, as it sums a lot of small terms.
+		struct Quadric
+		{
+			double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+			void addPlane(const glm::vec3& normal, float distance)
+			{
+				double a = normal.x, b = normal.y, c = normal.z, d = distance;
+				a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+				b2 += b * b; bc += b * c; bd += b * d;
+				c2 += c * c; cd += c * d;
+				d2 += d * d;
+			}
+
+			void add(const Quadric& other)
+			{
+				a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+				b2 += other.b2; bc += other.bc; bd += other.bd;
+				c2 += other.c2; cd += other.cd;
+				d2 += other.d2;
+			}
+
+			double error(const glm::vec3& point) const
+			{
+				double x = point.x, y = point.y, z = point.z;
+				double result = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+					+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+					+ c2 * z * z + 2 * cd * z
+					+ d2;
+				return std::max(result, 0.0);
+			}
+		};
+
+		struct Collapse
+		{
+			double cost;		//squared error it would introduce.
+			uint32_t from;		//vertex that goes.
+			uint32_t to;		//vertex it goes onto.
+		};
+
+		constexpr float maxNormalTurn = 0.25f;	//cosine of the furthest a collapse may turn a triangle, about 75 degrees.
+
+		uint64_t edgeKey(uint32_t a, uint32_t b) { return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a; }
+	}
+
+	float MeshSimplifier::simplify(const void * vertices, uint32_t vertexCount, const VertexBufferLayout & layout, const uint32_t * indices, uint32_t indexCount,
+		uint32_t targetIndexCount, float maxError, std::vector<uint32_t>& result)
+	{
+		result.assign(indices, indices + indexCount);
+
+		auto position = layout.begin();
+		if (!vertices || position == layout.end() || position->m_dataType != ShaderDataType::Float3 || indexCount <= targetIndexCount)
+			return 0.0f;
+
+		std::vector<glm::vec3> positions(vertexCount);
+		const unsigned char* bytes = static_cast<const unsigned char*>(vertices) + position->m_offset;
+		for (uint32_t i = 0; i < vertexCount; i++)
+			memcpy(&positions[i], bytes + i * layout.getStride(), sizeof(glm::vec3));
+
+		//seams; vertices sharing a position with another vertex are locked, moving one would tear the mesh open.
+		std::vector<bool> locked(vertexCount, false);
+		std::vector<uint32_t> order(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+			order[i] = i;
+		auto lessPosition = [&positions](uint32_t a, uint32_t b)
+		{
+			const glm::vec3& p = positions[a];
+			const glm::vec3& q = positions[b];
+			return p.x != q.x ? p.x < q.x : (p.y != q.y ? p.y < q.y : p.z < q.z);
+		};
+		std::sort(order.begin(), order.end(), lessPosition);
+		for (uint32_t i = 1; i < vertexCount; i++)
+		{
+			if (positions[order[i]] == positions[order[i - 1]])
+				locked[order[i]] = locked[order[i - 1]] = true;
+		}
+
+		//open borders; an edge used by only one triangle locks both its ends.
+		std::vector<uint64_t> edges;
+		edges.reserve(indexCount);
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			edges.push_back(edgeKey(indices[i], indices[i + 1]));
+			edges.push_back(edgeKey(indices[i + 1], indices[i + 2]));
+			edges.push_back(edgeKey(indices[i + 2], indices[i]));
+		}
+		std::sort(edges.begin(), edges.end());
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t run = i + 1;
+			while (run < edges.size() && edges[run] == edges[i])
+				run++;
+			if (run - i == 1)
+			{
+				locked[edges[i] >> 32] = true;
+				locked[edges[i] & 0xFFFFFFFF] = true;
+			}
+			i = run;
+		}
+
+		//each vertex starts with the planes of the triangles around it.
+		std::vector<Quadric> quadrics(vertexCount);
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			const glm::vec3& p0 = positions[indices[i]];
+			glm::vec3 normal = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+			float length = glm::length(normal);
+			if (length <= 0.0f)
+				continue;
+			normal = normal * (1.0f / length);
+
+			Quadric plane;
+			plane.addPlane(normal, -glm::dot(normal, p0));
+			for (uint32_t corner = 0; corner < 3; corner++)
+				quadrics[indices[i + corner]].add(plane);
+		}
+
+		uint32_t targetTriangles = targetIndexCount / 3;
+		double maxCost = static_cast<double>(maxError) * maxError;
+		double worstCost = 0.0;
+
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		std::vector<uint32_t> triangleStart(vertexCount + 1);
+		std::vector<uint32_t> vertexTriangles;
+
+		//in passes; each pass takes the cheapest collapses that don't touch each other, then the triangles are rebuilt and the costs worked out again.
+		while (result.size() / 3 > targetTriangles)
+		{
+			uint32_t triangleCount = result.size() / 3;
+
+			edges.clear();
+			for (uint32_t i = 0; i < result.size(); i += 3)
+			{
+				edges.push_back(edgeKey(result[i], result[i + 1]));
+				edges.push_back(edgeKey(result[i + 1], result[i + 2]));
+				edges.push_back(edgeKey(result[i + 2], result[i]));
+			}
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+			collapses.clear();
+			for (uint64_t edge : edges)
+			{
+				uint32_t a = edge >> 32;
+				uint32_t b = edge & 0xFFFFFFFF;
+				if (a == b || (locked[a] && locked[b]))
+					continue;
+
+				Quadric combined = quadrics[a];
+				combined.add(quadrics[b]);
+				double costAToB = locked[a] ? DBL_MAX : combined.error(positions[b]);
+				double costBToA = locked[b] ? DBL_MAX : combined.error(positions[a]);
+				if (costAToB <= costBToA)
+					collapses.push_back({ costAToB, a, b });
+				else
+					collapses.push_back({ costBToA, b, a });
+			}
+			if (collapses.empty())
+				break;
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+			//which triangles each vertex is in, for the flip test.
+			std::fill(triangleStart.begin(), triangleStart.end(), 0);
+			for (uint32_t index : result)
+				triangleStart[index + 1]++;
+			for (uint32_t i = 0; i < vertexCount; i++)
+				triangleStart[i + 1] += triangleStart[i];
+			vertexTriangles.resize(result.size());
+			std::vector<uint32_t> fill(triangleStart.begin(), triangleStart.end() - 1);
+			for (uint32_t i = 0; i < result.size(); i++)
+				vertexTriangles[fill[result[i]]++] = i / 3;
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+				remap[i] = i;
+			std::fill(touched.begin(), touched.end(), false);
+
+			uint32_t removed = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.cost > maxCost || triangleCount - removed <= targetTriangles)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+
+				//a collapse that turns any remaining triangle over, or flattens it to a line, would fold the surface.
+				bool flips = false;
+				uint32_t shared = 0;
+				for (uint32_t t = triangleStart[collapse.from]; t < triangleStart[collapse.from + 1] && !flips; t++)
+				{
+					const uint32_t* triangle = &result[vertexTriangles[t] * 3];
+					if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+					{
+						shared++;
+						continue;
+					}
+
+					glm::vec3 before[3], after[3];
+					for (uint32_t corner = 0; corner < 3; corner++)
+					{
+						before[corner] = positions[triangle[corner]];
+						after[corner] = triangle[corner] == collapse.from ? positions[collapse.to] : before[corner];
+					}
+					glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+					glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+					float lengthBefore = glm::length(normalBefore);
+					if (lengthBefore > 0.0f)
+						flips = glm::dot(normalBefore, normalAfter) <= maxNormalTurn * lengthBefore * glm::length(normalAfter);
+
+					//nor may it land on a triangle the vertex it goes onto already has, which would leave the two back to back.
+					uint32_t first = triangle[0] == collapse.from ? triangle[1] : triangle[0];
+					uint32_t second = triangle[2] == collapse.from ? triangle[1] : triangle[2];
+					for (uint32_t u = triangleStart[collapse.to]; u < triangleStart[collapse.to + 1] && !flips; u++)
+					{
+						const uint32_t* other = &result[vertexTriangles[u] * 3];
+						bool hasFirst = other[0] == first || other[1] == first || other[2] == first;
+						bool hasSecond = other[0] == second || other[1] == second || other[2] == second;
+						flips = hasFirst && hasSecond;
+					}
+				}
+				if (flips)
+					continue;
+
+				//everything around the vertex that goes has changed, so nothing else there collapses this pass.
+				for (uint32_t t = triangleStart[collapse.from]; t < triangleStart[collapse.from + 1]; t++)
+				{
+					const uint32_t* triangle = &result[vertexTriangles[t] * 3];
+					touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].add(quadrics[collapse.from]);
+				worstCost = std::max(worstCost, collapse.cost);
+				removed += shared;
+			}
+			if (removed == 0)
+				break;
+
+			//the triangles that had both ends of a collapsed edge are now degenerate and are dropped.
+			uint32_t write = 0;
+			for (uint32_t i = 0; i < result.size(); i += 3)
+			{
+				uint32_t a = remap[result[i]];
+				uint32_t b = remap[result[i + 1]];
+				uint32_t c = remap[result[i + 2]];
+				if (a == b || b == c || c == a)
+					continue;
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize(write);
+		}
+
+		return static_cast<float>(std::sqrt(worstCost));
+	}
+}
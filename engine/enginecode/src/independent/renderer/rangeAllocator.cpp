@@ -0,0 +1,63 @@
+/** \file rangeAllocator.cpp */
+
+#include "engine_pch.h"
+#include "renderer/rangeAllocator.h"
+
+namespace Engine
+{
+	RangeAllocator::RangeAllocator(uint32_t capacity) :
+		m_freeCount(capacity)
+	{
+		if (capacity > 0)
+			m_freeRanges.push_back({ 0, capacity });
+	}
+
+	bool RangeAllocator::allocate(uint32_t count, uint32_t & start)
+	{
+		for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it)
+		{
+			if (it->count < count)
+				continue;
+
+			start = it->start;
+			it->start += count;
+			it->count -= count;
+			if (it->count == 0)
+				m_freeRanges.erase(it);
+			m_freeCount -= count;
+			return true;
+		}
+
+		return false;
+	}
+
+	void RangeAllocator::release(uint32_t start, uint32_t count)
+	{
+		if (count == 0)
+			return;
+		m_freeCount += count;
+
+		//first free run after the one given back.
+		auto next = m_freeRanges.begin();
+		while (next != m_freeRanges.end() && next->start < start)
+			++next;
+
+		bool joinsPrevious = next != m_freeRanges.begin() && (next - 1)->start + (next - 1)->count == start;
+		bool joinsNext = next != m_freeRanges.end() && start + count == next->start;
+
+		if (joinsPrevious && joinsNext)
+		{
+			(next - 1)->count += count + next->count;
+			m_freeRanges.erase(next);
+		}
+		else if (joinsPrevious)
+			(next - 1)->count += count;
+		else if (joinsNext)
+		{
+			next->start = start;
+			next->count += count;
+		}
+		else
+			m_freeRanges.insert(next, { start, count });
+	}
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "engine_pch.h"
 #include "renderer/renderCommands.h"
 #include "rendering/renderAPI.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include <glad/glad.h>
 
 namespace Engine
@@ -34,7 +35,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return []()
 			{
-				glEnable(GL_DEPTH_TEST);
+				OpenGLStateCache::setEnabled(GL_DEPTH_TEST, true);
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -54,7 +55,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return []()
 			{
-				glDisable(GL_DEPTH_TEST);
+				OpenGLStateCache::setEnabled(GL_DEPTH_TEST, false);
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -74,7 +75,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return []()
 			{
-				glEnable(GL_BLEND);
+				OpenGLStateCache::setEnabled(GL_BLEND, true);
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -94,7 +95,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return []()
 			{
-				glDisable(GL_BLEND);
+				OpenGLStateCache::setEnabled(GL_BLEND, false);
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -114,7 +115,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return []()
 			{
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				OpenGLStateCache::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -135,7 +136,7 @@ namespace Engine
 		case RenderAPI::API::OpenGL:
 			return [r, g, b, a]()
 			{ 
-				glClearColor(r, g, b, a); 
+				OpenGLStateCache::clearColour(r, g, b, a); 
 			};
 		case RenderAPI::API::Direct3D:
 			return std::function<void(void)>();
@@ -0,0 +1,43 @@
+/** \file renderQueue.cpp */
+
+#include "engine_pch.h"
+#include "renderer/renderQueue.h"
+#include <array>
+
+namespace Engine
+{
+	void RenderQueue::sort()
+	{
+		uint32_t count = m_entries.size();
+		if (count < 2)
+			return;
+
+		m_scratch.resize(count);
+
+		//least significant byte first; each pass is stable so earlier passes break ties in later ones.
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			std::array<uint32_t, 256> histogram = {};
+			for (const auto& entry : m_entries)
+				histogram[(entry.key >> shift) & 0xFF]++;
+
+			//every key has the same byte here, the pass wouldn't move anything.
+			if (histogram[(m_entries[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			//turn the counts into where each bucket starts.
+			uint32_t total = 0;
+			for (auto& bucket : histogram)
+			{
+				uint32_t bucketCount = bucket;
+				bucket = total;
+				total += bucketCount;
+			}
+
+			for (const auto& entry : m_entries)
+				m_scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+
+			m_entries.swap(m_scratch);
+		}
+	}
+}
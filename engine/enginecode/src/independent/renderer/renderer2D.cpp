@@ -2,13 +2,40 @@
 
 #include "engine_pch.h"
 #include "renderer/renderer2D.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "systems/generalFunctions.h"
+#include <glm/gtc/constants.hpp>
+#include <cfloat>
+#include <cstring>
+#include <xmmintrin.h>
 
 namespace Engine
 {
 	//initialise static variables.
 	std::shared_ptr<Renderer2D::InternalData> Renderer2D::s_data = nullptr;
+	VertexBufferLayout Renderer2DVertex::s_BufferLayout = { ShaderDataType::Float2, ShaderDataType::Float2, ShaderDataType::Int, { ShaderDataType::Byte4, true } };
+	VertexBufferLayout Renderer2DInstance::s_BufferLayout = VertexBufferLayout({ ShaderDataType::Float2, ShaderDataType::Float2, { ShaderDataType::Short4, true }, { ShaderDataType::Short, true }, ShaderDataType::Short, { ShaderDataType::Byte4, true } }, 0, 1);
 
-	void Renderer2D::init()
+	static_assert(sizeof(Renderer2DInstance) == 32, "Renderer2DInstance should pack into 32 bytes");
+
+	Renderer2DInstance::Renderer2DInstance(const glm::vec2& translate, const glm::vec2& scale, const glm::vec2& UVStart, const glm::vec2& UVEnd, float angle, uint32_t textureUnit, uint32_t tint) :
+		m_translate(translate),
+		m_scale(scale),
+		m_textureUnit(static_cast<int16_t>(textureUnit)),
+		m_tint(tint)
+	{
+		//UVs 0 to 1 map onto 0 to the largest short.
+		auto packUV = [](float UV) { return static_cast<int16_t>(std::min(std::max(UV, 0.0f), 1.0f) * 32767.0f); };
+		m_UVRect[0] = packUV(UVStart.x);
+		m_UVRect[1] = packUV(UVStart.y);
+		m_UVRect[2] = packUV(UVEnd.x);
+		m_UVRect[3] = packUV(UVEnd.y);
+
+		//wrap into -pi to pi first so any angle survives the packing.
+		m_angle = static_cast<int16_t>(remainder(angle, glm::two_pi<float>()) / glm::pi<float>() * 32767.0f);
+	}
+
+	void Renderer2D::init(TextMode textMode)
 	{
 		s_data.reset(new InternalData);
 
@@ -26,7 +53,7 @@ namespace Engine
 			 0.5f, -0.5f, 1.0f, 0.0f
 		};		//the four vertices of a quad; -0.5 to 0.5 (rather that -1.0 to 1.0) for scaling.
 
-		uint32_t indices[4] = { 0, 1, 2, 3 };				//set the indices.
+		uint32_t indices[6] = { 0, 1, 2, 2, 3, 0 };			//set the indices, two triangles so it can be instanced.
 
 		//create a local VBO & IBO.
 		std::shared_ptr<VertexBuffer> VBO;
@@ -34,16 +61,54 @@ namespace Engine
 
 		s_data->VAO.reset(VertexArray::create());			//create a new vertex array.
 		VBO.reset(VertexBuffer::create(vertices, sizeof(vertices), VertexBufferLayout({ ShaderDataType::Float2, ShaderDataType::Float2 })));		//set the VBO with vertices array, its size and a vertexbufferlayout of two float2s.
-		IBO.reset(IndexBuffer::create(indices, 4));			//set the IBO wih indices array and its count (4).
+		IBO.reset(IndexBuffer::create(indices, 6));			//set the IBO wih indices array and its count (6).
 		
 		//add the VBO & IBO to the VAO.
 		s_data->VAO->addVertexBuffer(VBO);
 		s_data->VAO->setIndexBuffer(IBO);
 
-		//set the dimensions of the glyph buffer.
-		s_data->glyphBufferDimensions = { 256 };
-		s_data->glyphBufferSize = s_data->glyphBufferDimensions.x * s_data->glyphBufferDimensions.y * 4 * sizeof(unsigned char);
-		s_data->glyphBuffer.reset(static_cast<unsigned char*>(malloc(s_data->glyphBufferSize)));
+		//set up the batch; vertices are filled on the CPU, indices never change so are made once here.
+		s_data->batchCapacity = 16384;
+		s_data->batchQuadCount = 0;
+		s_data->batchVertices.resize(s_data->batchCapacity * 4);
+
+		std::vector<uint32_t> batchIndices(s_data->batchCapacity * 6);
+		for (uint32_t i = 0; i < s_data->batchCapacity; i++)
+		{
+			//two triangles per quad; 0,1,2 and 2,3,0.
+			batchIndices[i * 6 + 0] = i * 4 + 0;
+			batchIndices[i * 6 + 1] = i * 4 + 1;
+			batchIndices[i * 6 + 2] = i * 4 + 2;
+			batchIndices[i * 6 + 3] = i * 4 + 2;
+			batchIndices[i * 6 + 4] = i * 4 + 3;
+			batchIndices[i * 6 + 5] = i * 4 + 0;
+		}
+
+		std::shared_ptr<IndexBuffer> batchIBO;
+		s_data->batchVAO.reset(VertexArray::create());
+		s_data->batchVBO.reset(VertexBuffer::create(nullptr, sizeof(Renderer2DVertex) * s_data->batchVertices.size(), Renderer2DVertex::getBufferLayout()));
+		batchIBO.reset(IndexBuffer::create(batchIndices.data(), batchIndices.size()));
+		s_data->batchVAO->addVertexBuffer(s_data->batchVBO);
+		s_data->batchVAO->setIndexBuffer(batchIBO);
+
+		//set up the instanced path; one 32 byte record per quad, stepped once per instance of the prototypical quad.
+		s_data->instanced = false;
+		s_data->drawingInstanced = false;
+		s_data->instances.resize(s_data->batchCapacity);
+		s_data->instanceVBO.reset(VertexBuffer::create(nullptr, sizeof(Renderer2DInstance) * s_data->instances.size(), Renderer2DInstance::getBufferLayout()));
+		s_data->VAO->addVertexBuffer(s_data->instanceVBO);
+		s_data->instanceShader.reset(Shaders::create("./assets/shaders/quadInstanced.glsl"));
+
+		//texture units for the batch, the shader has a sampler per unit.
+		s_data->textureUnitManager = TextureUnitManager(s_data->textureUnits.size());
+		for (uint32_t i = 0; i < s_data->textureUnits.size(); i++)
+			s_data->textureUnits[i] = i;
+
+		for (auto& shader : { s_data->shader, s_data->instanceShader })
+		{
+			OpenGLStateCache::useProgram(shader->getID());
+			shader->uploadIntArray("u_texData", s_data->textureUnits.data(), s_data->textureUnits.size());
+		}
 
 		//initalise freetype.
 		if (FT_Init_FreeType(&s_data->ft))
@@ -54,74 +119,117 @@ namespace Engine
 		if (FT_New_Face(s_data->ft, filePath, 0, &s_data->fontFace))
 			Log::error("ERROR: font could NOT be loaded: {0}", filePath);
 
-		//create a character size and set it.
-		int32_t characterSize = 86;
-		if (FT_Set_Pixel_Sizes(s_data->fontFace, 0, characterSize))
-			Log::error("ERROR: font size NOT set: {0}", characterSize);
+		//text is drawn at this size unless told otherwise.
+		s_data->textSize = 86.0f;
 
-		//initialise the font texture.
-		s_data->fontTexture.reset(Textures::create(s_data->glyphBufferDimensions.x, s_data->glyphBufferDimensions.y, 4, nullptr));
+		if (textMode == TextMode::SDF)
+		{
+			//distance fields scale, so rasterise once at a moderate size with 8 pixels of spread either side of the edge.
+			s_data->fontSize = 64;
+			s_data->textFlags = Renderer2DVertex::flag_SDF;
+			s_data->glyphAtlas.reset(new GlyphAtlas(1024, 1024, 1, GlyphMode::SDF, 8));
+
+			//generating the fields is the slow part, so do printable ASCII now across the job system rather than on first use.
+			std::vector<uint32_t> codepoints;
+			for (uint32_t ch = 32; ch < 127; ch++)
+				codepoints.push_back(ch);
+			s_data->glyphAtlas->prewarm(s_data->fontFace, s_data->fontSize, codepoints);
+		}
+		else
+		{
+			//bitmaps only look right at the size they are drawn, glyphs are added to the atlas as they are first drawn.
+			s_data->fontSize = static_cast<uint32_t>(s_data->textSize);
+			s_data->textFlags = 0;
+			s_data->glyphAtlas.reset(new GlyphAtlas(1024, 1024));
+		}
 
-		//fill the glyph buffer (using old c function memset as they're fast).
-		memset(s_data->glyphBuffer.get(), 60, s_data->glyphBufferSize);
+		if (FT_Set_Pixel_Sizes(s_data->fontFace, 0, s_data->fontSize))
+			Log::error("ERROR: font size NOT set: {0}", s_data->fontSize);
 
-		//send glyph buffer to the texture on GPU.
-		s_data->fontTexture->edit(0, 0, s_data->glyphBufferDimensions.x, s_data->glyphBufferDimensions.y, s_data->glyphBuffer.get());
+		s_data->textRuns.reset(new TextRunCache(s_data->glyphAtlas));
 	}
 
 	void Renderer2D::begin(const SceneWideUniforms& swu)
 	{
-		//first bind the shader.
-		glUseProgram(s_data->shader->getID());
+		//both paths' shaders need the scene wide uniforms, the path can be switched mid scene.
+		for (auto& shader : { s_data->shader, s_data->instanceShader })
+		{
+			//first bind the shader.
+			OpenGLStateCache::useProgram(shader->getID());
 
-		//apply scene wide uniforms to the shader. 
+			//apply scene wide uniforms to the shader. 
+			for (auto& dataPair : swu)
+			{
+				const char* uniformName = dataPair.first;
+				ShaderDataType sdt = dataPair.second.first;
+				void * addressValue = dataPair.second.second;
+
+				switch (sdt)
+				{
+				case ShaderDataType::Int:
+					shader->uploadInt(uniformName, *(int *)addressValue);
+					break;
+				case ShaderDataType::Float3:
+					shader->uploadFloat3(uniformName, *(glm::vec3 *)addressValue);
+					break;
+				case ShaderDataType::Float4:
+					shader->uploadFloat4(uniformName, *(glm::vec4 *)addressValue);
+					break;
+				case ShaderDataType::Mat4:
+					shader->uploadMat4(uniformName, *(glm::mat4 *)addressValue);
+					break;
+				}
+			}
+		}
+
+		//start with an empty batch; other renderers may have changed the units since the last scene.
+		s_data->batchQuadCount = 0;
+		s_data->textureUnitManager.clear();
+		s_data->stats = Renderer2DStats();
+
+		//nothing recorded yet.
+		s_data->packets.clear();
+		s_data->packetKeys.clear();
+		s_data->boundsMinX.clear();
+		s_data->boundsMinY.clear();
+		s_data->boundsMaxX.clear();
+		s_data->boundsMaxY.clear();
+		s_data->queue.clear();
+		s_data->layer = 0;
+
+		//the view rectangle is the corners of clip space taken back into the world; culling is off without both matrices.
+		const glm::mat4* view = nullptr;
+		const glm::mat4* projection = nullptr;
 		for (auto& dataPair : swu)
 		{
-			const char* uniformName = dataPair.first;
-			ShaderDataType sdt = dataPair.second.first;
-			void * addressValue = dataPair.second.second;
+			if (dataPair.second.first != ShaderDataType::Mat4)
+				continue;
+			if (strcmp(dataPair.first, "u_view") == 0)
+				view = static_cast<glm::mat4*>(dataPair.second.second);
+			else if (strcmp(dataPair.first, "u_projection") == 0)
+				projection = static_cast<glm::mat4*>(dataPair.second.second);
+		}
 
-			switch (sdt)
+		s_data->culling = view && projection;
+		if (s_data->culling)
+		{
+			glm::mat4 clipToWorld = glm::inverse(*projection * *view);
+			glm::vec2 corners[4] = { { -1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f } };
+
+			s_data->viewMin = glm::vec2(FLT_MAX);
+			s_data->viewMax = glm::vec2(-FLT_MAX);
+			for (const auto& corner : corners)
 			{
-			case ShaderDataType::Int:
-				s_data->shader->uploadInt(uniformName, *(int *)addressValue);
-				break;
-			case ShaderDataType::Float3:
-				s_data->shader->uploadFloat3(uniformName, *(glm::vec3 *)addressValue);
-				break;
-			case ShaderDataType::Float4:
-				s_data->shader->uploadFloat4(uniformName, *(glm::vec4 *)addressValue);
-				break;
-			case ShaderDataType::Mat4:
-				s_data->shader->uploadMat4(uniformName, *(glm::mat4 *)addressValue);
-				break;
+				glm::vec4 world = clipToWorld * glm::vec4(corner, 0.0f, 1.0f);
+				s_data->viewMin = glm::min(s_data->viewMin, glm::vec2(world));
+				s_data->viewMax = glm::max(s_data->viewMax, glm::vec2(world));
 			}
 		}
-
-		//bind geometry (VAO & IBO).
-		glBindVertexArray(s_data->VAO->getID());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_data->VAO->getIndexBuffer()->getID());
 	}
 		
 	void Renderer2D::submit(const Quad & quad, const glm::vec4 & tint, const std::shared_ptr<Textures>& texture)
 	{
-		//first bind the default texture.
-		glBindTexture(GL_TEXTURE_2D, texture->getID());
-
-		//now create the model by translating and scaling the model.
-		s_data->model = glm::scale(glm::translate(glm::mat4(1.0f), quad.m_translate), quad.m_scale);
-
-		//upload any per-draw-uniforms.
-		s_data->shader->uploadInt("u_texData", 0);				//the texture data.
-		s_data->shader->uploadFloat4("u_tint", tint);			//the tint data.
-		s_data->shader->uploadMat4("u_model", s_data->model);	//the transform of the model.
-
-		//bind geometry (VAO & IBO).
-		glBindVertexArray(s_data->VAO->getID());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_data->VAO->getIndexBuffer()->getID());
-
-		//now draw it; remember using QUADS, not TRIANGLES.
-		glDrawElements(GL_QUADS, s_data->VAO->getDrawCount(), GL_UNSIGNED_INT, nullptr);
+		recordQuad(glm::vec2(quad.m_translate), glm::vec2(quad.m_scale), 0.0f, GenFuncs::package(tint), texture->getID(), { 0.0f, 0.0f }, { 1.0f, 1.0f }, isTranslucent(tint, texture));
 	}
 
 	void Renderer2D::submit(const Quad & quad, const glm::vec4 & tint)
@@ -142,23 +250,7 @@ namespace Engine
 			angle = glm::radians(angle);
 		}
 
-		//first bind the default texture.
-		glBindTexture(GL_TEXTURE_2D, texture->getID());
-
-		//now create the model by translating & scaling the model, plus the rotation.
-		s_data->model = glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), quad.m_translate), angle, { 0.0f, 0.0f, 1.0f }), quad.m_scale);
-
-		//upload any per-draw-uniforms.
-		s_data->shader->uploadInt("u_texData", 0);				//the texture data.
-		s_data->shader->uploadFloat4("u_tint", tint);			//the tint data.
-		s_data->shader->uploadMat4("u_model", s_data->model);	//the transform of the model.
-
-		//bind geometry (VAO & IBO).
-		glBindVertexArray(s_data->VAO->getID());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_data->VAO->getIndexBuffer()->getID());
-
-		//now draw it; remember using QUADS, not TRIANGLES.
-		glDrawElements(GL_QUADS, s_data->VAO->getDrawCount(), GL_UNSIGNED_INT, nullptr);
+		recordQuad(glm::vec2(quad.m_translate), glm::vec2(quad.m_scale), angle, GenFuncs::package(tint), texture->getID(), { 0.0f, 0.0f }, { 1.0f, 1.0f }, isTranslucent(tint, texture));
 	}
 
 	void Renderer2D::submit(const Quad& quad, const glm::vec4& tint, float angle, bool degrees)
@@ -171,78 +263,334 @@ namespace Engine
 		Renderer2D::submit(quad, s_data->defaultTint, texture, angle, degrees);
 	}
 	
-	void Renderer2D::submit(char ch, const glm::vec2& position, float& advance, const glm::vec4& tint)
+	void Renderer2D::submit(const Quad & quad, const SubTexture & subTexture)
 	{
-		if (FT_Load_Char(s_data->fontFace, ch, FT_LOAD_RENDER))
+		Renderer2D::submit(quad, s_data->defaultTint, subTexture);
+	}
+
+	void Renderer2D::submit(const Quad & quad, const glm::vec4 & tint, const SubTexture & subTexture, float angle, bool degrees)
+	{
+		if (degrees)
 		{
-			Log::error("Error: Freetype could NOT load the glyph for {0}", ch);
+			angle = glm::radians(angle);
 		}
-		else
+
+		recordQuad(glm::vec2(quad.m_translate), glm::vec2(quad.m_scale), angle, GenFuncs::package(tint), subTexture.getBaseTexture()->getID(), subTexture.getUVStart(), subTexture.getUVEnd(), isTranslucent(tint, subTexture.getBaseTexture()));
+	}
+
+	void Renderer2D::submit(char ch, const glm::vec2& position, float& advance, const glm::vec4& tint)
+	{
+		//only rasterised the first time it's seen, after that it's a lookup.
+		const GlyphInfo& glyph = s_data->glyphAtlas->getGlyph(s_data->fontFace, s_data->fontSize, static_cast<unsigned char>(ch));
+
+		//the atlas size and the drawn size only differ in SDF mode.
+		float scale = s_data->textSize / s_data->fontSize;
+		advance = glyph.advance * scale;
+
+		//nothing to draw for spaces etc.
+		if (glyph.size.x == 0.0f || glyph.size.y == 0.0f)
+			return;
+
+		//quad for the glyph, placed from the pen position by its bearing.
+		glm::vec2 glyphCentre = position + (glyph.bearing + glyph.size * 0.5f) * scale;
+		recordQuad(glyphCentre, glyph.size * scale, 0.0f, GenFuncs::package(tint), s_data->glyphAtlas->getTexture()->getID(), glyph.UVStart, glyph.UVEnd, true, s_data->textFlags);
+	}
+
+	void Renderer2D::submit(const char * text, const glm::vec2 & position, const glm::vec4& tint)
+	{
+		Renderer2D::submit(text, position, tint, s_data->textSize);
+	}
+
+	void Renderer2D::submit(const char * text, const glm::vec2 & position, const glm::vec4 & tint, float pixelSize)
+	{
+		//laid out the first time the string is drawn, after that it is copied straight into the batch.
+		//runs are laid out at the atlas size and scaled here, so one run serves every size.
+		const TextRun& run = s_data->textRuns->getRun(text, s_data->fontFace, s_data->fontSize);
+		recordTextRun(run, position, GenFuncs::package(tint), pixelSize / s_data->fontSize);
+	}
+	
+	void Renderer2D::setLayer(uint8_t layer)
+	{
+		s_data->layer = layer;
+	}
+
+	void Renderer2D::end()
+	{
+		s_data->stats.packets = s_data->packets.size();
+
+		//drop anything off screen before it costs a sort, a transform or a draw.
+		cullPackets();
+		s_data->stats.visible = s_data->queue.getCount();
+		s_data->stats.culled = s_data->stats.packets - s_data->stats.visible;
+
+		//order by layer, then opaque by state and translucent back to front.
+		s_data->queue.sort();
+
+		for (const auto& entry : s_data->queue.getEntries())
 		{
-			//get the glyph data.
-			uint32_t glyphWidth = s_data->fontFace->glyph->bitmap.width;
-			uint32_t glyphHeight = s_data->fontFace->glyph->bitmap.rows;
-			glm::vec2 glyphSize(glyphWidth, glyphHeight);
-			glm::vec2 glyphBearing(s_data->fontFace->glyph->bitmap_left, -s_data->fontFace->glyph->bitmap_top);
-
-			//calculate the advance
-			advance = static_cast<float>(s_data->fontFace->glyph->advance.x >> 6);
-
-			//calculate quad for glyph.
-			glm::vec2 glyphHalfExtents(s_data->fontTexture->getWidthF() * 0.5f, s_data->fontTexture->getHeightF() * 0.5f);
-			glm::vec2 glyphCentre = (position + glyphBearing) + glyphHalfExtents;
-			Quad quad = Quad::createCentreHalfExtents(glyphCentre, glyphHalfExtents);
-
-			//create a RGBA buffer for glyph.
-			RtoRGBA(s_data->fontFace->glyph->bitmap.buffer, glyphWidth, glyphHeight);
-			//send to GPU.
-			s_data->fontTexture->edit(0, 0, s_data->glyphBufferDimensions.x, s_data->glyphBufferDimensions.y, s_data->glyphBuffer.get());
-
-			//submit quad
-			submit(quad, tint, s_data->fontTexture);
+			const Packet& packet = s_data->packets[entry.index];
+
+			//whatever is already in the batch was written for the other path.
+			if (packet.instanced != s_data->drawingInstanced)
+			{
+				flushBatch();
+				s_data->drawingInstanced = packet.instanced;
+			}
+
+			if (packet.run)
+				appendTextRun(*packet.run, packet.centre, packet.tint, packet.size.x);
+			else
+				appendQuad(packet.centre, packet.size, packet.angle, packet.tint, packet.textureID, packet.UVStart, packet.UVEnd, packet.unitFlags);
 		}
+
+		flushBatch();
+
+		s_data->packets.clear();
+		s_data->packetKeys.clear();
+		s_data->boundsMinX.clear();
+		s_data->boundsMinY.clear();
+		s_data->boundsMaxX.clear();
+		s_data->boundsMaxY.clear();
+		s_data->queue.clear();
 	}
 
-	void Renderer2D::submit(const char * text, const glm::vec2 & position, const glm::vec4& tint)
+	void Renderer2D::endFrame()
+	{
+		//not per scene, so a frame drawing its text over two scenes doesn't age runs twice as fast.
+		s_data->textRuns->endFrame();
+	}
+
+	void Renderer2D::setInstanced(bool instanced)
 	{
-		//calculate the length of the string using strlen
-		uint32_t len = strlen(text);
+		s_data->instanced = instanced;
+	}
+
+	void Renderer2D::recordQuad(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureID, const glm::vec2& UVStart, const glm::vec2& UVEnd, bool translucent, uint32_t unitFlags)
+	{
+		//bounding box of the quad once rotated.
+		float c = fabs(cos(angle));
+		float s = fabs(sin(angle));
+		glm::vec2 halfExtents(0.5f * (c * size.x + s * size.y), 0.5f * (s * size.x + c * size.y));
+
+		uint32_t depth = s_data->packets.size();
+		recordPacket({ centre, size, UVStart, UVEnd, angle, tint, textureID, unitFlags, s_data->instanced, nullptr }, makeSortKey(translucent, s_data->instanced, textureID, depth), centre - halfExtents, centre + halfExtents);
+	}
 
-		float advance = 0.0f;
-		float x = position.x;
+	void Renderer2D::recordTextRun(const TextRun & run, const glm::vec2 & position, uint32_t tint, float scale)
+	{
+		uint32_t textureID = s_data->glyphAtlas->getTexture()->getID();
+		uint32_t depth = s_data->packets.size();
+		recordPacket({ position, { scale, scale }, { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, tint, textureID, s_data->textFlags, s_data->instanced, &run }, makeSortKey(true, s_data->instanced, textureID, depth), position + run.boundsMin * scale, position + run.boundsMax * scale);
+	}
 
-		for (int32_t i = 0; i < len; i++)
+	void Renderer2D::recordPacket(const Packet & packet, uint64_t key, const glm::vec2 & boundsMin, const glm::vec2 & boundsMax)
+	{
+		s_data->packets.push_back(packet);
+		s_data->packetKeys.push_back(key);
+		s_data->boundsMinX.push_back(boundsMin.x);
+		s_data->boundsMinY.push_back(boundsMin.y);
+		s_data->boundsMaxX.push_back(boundsMax.x);
+		s_data->boundsMaxY.push_back(boundsMax.y);
+	}
+
+	void Renderer2D::cullPackets()
+	{
+		uint32_t count = s_data->packets.size();
+
+		if (!s_data->culling)
 		{
-			submit(text[i], { x, position.y }, advance, tint);
-			x += advance;
+			for (uint32_t i = 0; i < count; i++)
+				s_data->queue.push(s_data->packetKeys[i], i);
+			return;
+		}
+
+		const float* minX = s_data->boundsMinX.data();
+		const float* minY = s_data->boundsMinY.data();
+		const float* maxX = s_data->boundsMaxX.data();
+		const float* maxY = s_data->boundsMaxY.data();
+
+		__m128 viewMinX = _mm_set1_ps(s_data->viewMin.x);
+		__m128 viewMinY = _mm_set1_ps(s_data->viewMin.y);
+		__m128 viewMaxX = _mm_set1_ps(s_data->viewMax.x);
+		__m128 viewMaxY = _mm_set1_ps(s_data->viewMax.y);
+
+		//four boxes at a time; a box is visible if it overlaps the view on both axes.
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 overlapX = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(maxX + i), viewMinX), _mm_cmple_ps(_mm_loadu_ps(minX + i), viewMaxX));
+			__m128 overlapY = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(maxY + i), viewMinY), _mm_cmple_ps(_mm_loadu_ps(minY + i), viewMaxY));
+			int visible = _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if (visible & (1 << lane))
+					s_data->queue.push(s_data->packetKeys[i + lane], i + lane);
+			}
+		}
+
+		//whatever doesn't fill a group of four.
+		for (; i < count; i++)
+		{
+			if (maxX[i] >= s_data->viewMin.x && minX[i] <= s_data->viewMax.x && maxY[i] >= s_data->viewMin.y && minY[i] <= s_data->viewMax.y)
+				s_data->queue.push(s_data->packetKeys[i], i);
 		}
 	}
-	
-	void Renderer2D::end()
+
+	uint64_t Renderer2D::makeSortKey(bool translucent, uint32_t shader, uint32_t textureID, uint32_t depth)
 	{
+		/* from the top bit down:
+		* layer			8 bits
+		* translucent	1 bit
+		* opaque:		shader 7 bits, texture 16 bits, depth 32 bits; state first so quads sharing it end up next to each other.
+		* translucent:	depth 32 bits, shader 7 bits, texture 16 bits; depth first so they blend back to front.
+		*/
+		uint64_t key = static_cast<uint64_t>(s_data->layer) << 56;
+		uint64_t state = (static_cast<uint64_t>(shader & 0x7F) << 16) | (textureID & 0xFFFF);
+
+		if (translucent)
+			key |= (1ull << 55) | (static_cast<uint64_t>(depth) << 23) | state;
+		else
+			key |= (state << 32) | depth;
 
+		return key;
 	}
 
-	void Renderer2D::RtoRGBA(unsigned char * rBuffer, uint32_t width, uint32_t height)
+	bool Renderer2D::isTranslucent(const glm::vec4 & tint, const std::shared_ptr<Textures>& texture)
 	{
-		memset(s_data->glyphBuffer.get(), 0, s_data->glyphBufferSize);
+		//any 4 channel texture might have alpha, except the white one.
+		return tint.a < 1.0f || (texture->getChannel() == 4 && texture != s_data->defaultTexture);
+	}
+
+	void Renderer2D::appendQuad(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureID, const glm::vec2& UVStart, const glm::vec2& UVEnd, uint32_t unitFlags)
+	{
+		//batch full, so draw what we have and start again.
+		if (s_data->batchQuadCount == s_data->batchCapacity)
+			flushBatch();
 
-		//ptr walker pointing towards the result.
-		unsigned char * pWalker = s_data->glyphBuffer.get();
+		uint32_t textureUnit = getTextureUnit(textureID) | unitFlags;
 
-		for (int32_t i = 0; i < height; i++)
+		if (s_data->drawingInstanced)
 		{
-			for (int32_t j = 0; j < width; j++)
+			appendInstance(centre, size, angle, tint, textureUnit, UVStart, UVEnd);
+			return;
+		}
+
+		//half axes of the quad after scale and rotation; same as translate * rotate * scale on the unit quad.
+		float c = cos(angle);
+		float s = sin(angle);
+		glm::vec2 halfX(c * size.x * 0.5f, s * size.x * 0.5f);
+		glm::vec2 halfY(-s * size.y * 0.5f, c * size.y * 0.5f);
+
+		//corners in the same order as the prototypical quad.
+		Renderer2DVertex* vertex = &s_data->batchVertices[s_data->batchQuadCount * 4];
+		vertex[0] = Renderer2DVertex(centre - halfX - halfY, { UVStart.x, UVStart.y }, textureUnit, tint);
+		vertex[1] = Renderer2DVertex(centre - halfX + halfY, { UVStart.x, UVEnd.y }, textureUnit, tint);
+		vertex[2] = Renderer2DVertex(centre + halfX + halfY, { UVEnd.x, UVEnd.y }, textureUnit, tint);
+		vertex[3] = Renderer2DVertex(centre + halfX - halfY, { UVEnd.x, UVStart.y }, textureUnit, tint);
+
+		s_data->batchQuadCount++;
+	}
+
+	void Renderer2D::appendTextRun(const TextRun & run, const glm::vec2 & position, uint32_t tint, float scale)
+	{
+		uint32_t textureUnit = getTextureUnit(s_data->glyphAtlas->getTexture()->getID()) | s_data->textFlags;
+
+		if (s_data->drawingInstanced)
+		{
+			for (const TextRunGlyph& glyph : run.glyphs)
+				appendInstance(position + (glyph.min + glyph.max) * 0.5f * scale, (glyph.max - glyph.min) * scale, 0.0f, tint, textureUnit, glyph.UVStart, glyph.UVEnd);
+			return;
+		}
+
+		uint32_t glyphIndex = 0;
+		while (glyphIndex < run.glyphs.size())
+		{
+			if (s_data->batchQuadCount == s_data->batchCapacity)
+				flushBatch();
+
+			//copy as much of the run as fits in the batch in one go.
+			uint32_t count = std::min(static_cast<uint32_t>(run.glyphs.size()) - glyphIndex, s_data->batchCapacity - s_data->batchQuadCount);
+			Renderer2DVertex* vertex = &s_data->batchVertices[s_data->batchQuadCount * 4];
+
+			for (uint32_t i = 0; i < count; i++, vertex += 4)
 			{
-				*pWalker = 255; pWalker++;	//R
-				*pWalker = 255; pWalker++;	//B
-				*pWalker = 255; pWalker++;	//G
-				*pWalker = *rBuffer;		//set the alpha channel.
-				pWalker++;		//go to R of the next pixel.
-				rBuffer++;		//go to next monochrome pixel.
+				const TextRunGlyph& glyph = run.glyphs[glyphIndex + i];
+				glm::vec2 min = position + glyph.min * scale;
+				glm::vec2 max = position + glyph.max * scale;
+
+				vertex[0] = Renderer2DVertex({ min.x, min.y }, { glyph.UVStart.x, glyph.UVStart.y }, textureUnit, tint);
+				vertex[1] = Renderer2DVertex({ min.x, max.y }, { glyph.UVStart.x, glyph.UVEnd.y }, textureUnit, tint);
+				vertex[2] = Renderer2DVertex({ max.x, max.y }, { glyph.UVEnd.x, glyph.UVEnd.y }, textureUnit, tint);
+				vertex[3] = Renderer2DVertex({ max.x, min.y }, { glyph.UVEnd.x, glyph.UVStart.y }, textureUnit, tint);
 			}
-			pWalker += (s_data->glyphBufferDimensions.x - width) * 4;		//times 4 as 4 channels.
+
+			s_data->batchQuadCount += count;
+			glyphIndex += count;
+		}
+	}
+
+	uint32_t Renderer2D::getTextureUnit(uint32_t textureID)
+	{
+		//all units taken and this texture isn't one of them; draw the batch before any units are reused.
+		if (s_data->textureUnitManager.isFull() && !s_data->textureUnitManager.isBound(textureID))
+		{
+			flushBatch();
+			s_data->textureUnitManager.clear();
+		}
+
+		uint32_t textureUnit;
+		if (s_data->textureUnitManager.getUnit(textureID, textureUnit))
+		{
+			OpenGLStateCache::bindTextureUnit(textureUnit, textureID);
+			s_data->stats.textureBinds++;
+		}
+
+		return textureUnit;
+	}
+
+	void Renderer2D::appendInstance(const glm::vec2& centre, const glm::vec2& size, float angle, uint32_t tint, uint32_t textureUnit, const glm::vec2& UVStart, const glm::vec2& UVEnd)
+	{
+		if (s_data->batchQuadCount == s_data->batchCapacity)
+			flushBatch();
+
+		s_data->instances[s_data->batchQuadCount] = Renderer2DInstance(centre, size, UVStart, UVEnd, angle, textureUnit, tint);
+		s_data->batchQuadCount++;
+	}
+
+	void Renderer2D::flushBatch()
+	{
+		if (s_data->batchQuadCount == 0)
+			return;
+
+		if (s_data->drawingInstanced)
+		{
+			//one record per quad, the prototypical quad is drawn once for each.
+			uint32_t size = sizeof(Renderer2DInstance) * s_data->batchQuadCount;
+			s_data->instanceVBO->edit(s_data->instances.data(), size, 0);
+
+			OpenGLStateCache::useProgram(s_data->instanceShader->getID());
+			OpenGLStateCache::bindVertexArray(s_data->VAO->getID());
+			glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, s_data->batchQuadCount);
+
+			s_data->stats.bytesUploaded += size;
 		}
+		else
+		{
+			//send only the part of the batch that has been filled.
+			uint32_t size = sizeof(Renderer2DVertex) * s_data->batchQuadCount * 4;
+			s_data->batchVBO->edit(s_data->batchVertices.data(), size, 0);
+
+			OpenGLStateCache::useProgram(s_data->shader->getID());
+			OpenGLStateCache::bindVertexArray(s_data->batchVAO->getID());
+			glDrawElements(GL_TRIANGLES, s_data->batchQuadCount * 6, GL_UNSIGNED_INT, nullptr);
+
+			s_data->stats.bytesUploaded += size;
+		}
+
+		s_data->stats.drawCalls++;
+		s_data->stats.quads += s_data->batchQuadCount;
+		s_data->batchQuadCount = 0;
 	}
 
 	Quad Quad::createCentreHalfExtents(const glm::vec2& centre, const glm::vec2& halfExtents)
@@ -2,6 +2,13 @@
 
 #include "engine_pch.h"
 #include "renderer/renderer3D.h"
+#include "platform/OpenGL/OpenGLShader.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "systems/jobSystem.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <xmmintrin.h>
 
 namespace Engine
 {
@@ -12,16 +19,17 @@ namespace Engine
 	{
 		s_data.reset(new InternalData);
 
+		//the shaders find their draw data with gl_BaseInstanceARB, which core GL only has from 4.6.
+		if (!OpenGLShader::hasExtension("GL_ARB_shader_draw_parameters"))
+			Log::error("Renderer3D needs GL_ARB_shader_draw_parameters; shaders reading b_draws won't compile without it");
+
 		unsigned char whitePixel[4] = { 255, 255, 255, 255 };		//a white pixel.
 		s_data->defaultTexture.reset(Textures::create(1, 1, 4, whitePixel));
 		s_data->defaultTint = { 1.0f, 1.0f, 1.0f, 1.0f };
 
-		//set the UBOs for the camera.
-		s_data->cameraUBO.reset(UniformBuffer::create(UniformBufferLayout(
-			{
-				{ "u_projection", ShaderDataType::Mat4 },
-				{ "u_view", ShaderDataType::Mat4  }
-			})));
+		//room for about 13000 draws a scene before it has to grow.
+		s_data->drawData.reset(RingBuffer::create(1024 * 1024));
+
 		//set the UBOs for the lighting.
 		s_data->lightingUBO.reset(UniformBuffer::create(UniformBufferLayout(
 			{
@@ -29,71 +37,795 @@ namespace Engine
 				{ "u_viewPos", ShaderDataType::Float3 },
 				{ "u_lightColour", ShaderDataType::Float3 }
 			})));
+		if (s_data->lightingUBO->getLayout().getStride() != LightingLayout::size)
+			Log::error("Renderer3D lighting block is {0} bytes, expected {1}", s_data->lightingUBO->getLayout().getStride(), LightingLayout::size);
+	}
+
+	MaterialHandle Renderer3D::createMaterial(const Material & material)
+	{
+		uint32_t index;
+		if (s_data->freeMaterials.empty())
+		{
+			index = s_data->materials.size();
+			s_data->materials.emplace_back();
+			s_data->materialParameters.emplace_back();
+		}
+		else
+		{
+			index = s_data->freeMaterials.back();
+			s_data->freeMaterials.pop_back();
+		}
+
+		bake(index, material);
+
+		return MaterialHandle(index);
+	}
+
+	void Renderer3D::updateMaterial(MaterialHandle handle, const Material & material)
+	{
+		if (handle.getIndex() >= s_data->materials.size() || !s_data->materials[handle.getIndex()].shader)
+		{
+			Log::error("Renderer3D has no material {0} to update", handle.getIndex());
+			return;
+		}
+
+		bake(handle.getIndex(), material);
+	}
+
+	void Renderer3D::setMaterialTint(MaterialHandle handle, const glm::vec4 & tint)
+	{
+		if (handle.getIndex() >= s_data->materials.size() || !s_data->materials[handle.getIndex()].shader)
+		{
+			Log::error("Renderer3D has no material {0} to tint", handle.getIndex());
+			return;
+		}
+
+		uint32_t index = handle.getIndex();
+		BakedMaterial& baked = s_data->materials[index];
+		MaterialParameters& parameters = s_data->materialParameters[index];
+
+		//a variant built without a tint ignores it, so one that has it is picked.
+		if (baked.variants && !(parameters.flags & Material::flag_tint))
+		{
+			baked.shader = baked.variants->get(Material::getDefines(parameters.flags | Material::flag_tint));
+			baked.shaderID = getDrawnShaderID(baked.shader);
+			prepareShader(baked.shader);
+		}
+
+		parameters.tint = tint;
+		parameters.flags |= Material::flag_tint;
+		s_data->materials[index].translucent = tint.a < 1.0f;
+		s_data->dirtyBegin = std::min(s_data->dirtyBegin, index);
+		s_data->dirtyEnd = std::max(s_data->dirtyEnd, index + 1);
+	}
+
+	void Renderer3D::destroyMaterial(MaterialHandle handle)
+	{
+		if (handle.getIndex() >= s_data->materials.size() || !s_data->materials[handle.getIndex()].shader)
+		{
+			Log::error("Renderer3D has no material {0} to destroy", handle.getIndex());
+			return;
+		}
+
+		//its parameters stay in the block until the index is baked again; nothing draws with them meanwhile.
+		releaseBindingTable(s_data->materials[handle.getIndex()].bindingTable);
+		s_data->materials[handle.getIndex()] = BakedMaterial();
+		s_data->freeMaterials.push_back(handle.getIndex());
+	}
+
+	void Renderer3D::bake(uint32_t index, const Material & material)
+	{
+		MaterialParameters& parameters = s_data->materialParameters[index];
+		parameters = MaterialParameters();
+		parameters.tint = material.isFlagSet(Material::flag_tint) ? material.getTint() : s_data->defaultTint;
+		for (uint32_t flag = Material::flag_diffuseTexture; flag <= Material::flag_tint; flag <<= 1)
+		{
+			if (material.isFlagSet(flag))
+				parameters.flags |= flag;
+		}
+
+		//a material baked again lets go of its old table only once it has its new one, so a table it keeps isn't released in between.
+		BakedMaterial& baked = s_data->materials[index];
+		bool rebaked = static_cast<bool>(baked.shader);
+		uint32_t previousTable = baked.bindingTable;
+
+		//the variant for exactly these flags, compiled the first time any material needs it.
+		baked.variants = material.getShaderVariants();
+		baked.shader = baked.variants ? baked.variants->get(Material::getDefines(parameters.flags)) : material.getShader();
+		if (!baked.shader)
+		{
+			Log::error("Renderer3D was given a material with no shader");
+			if (rebaked)
+				releaseBindingTable(previousTable);
+			baked = BakedMaterial();
+			return;
+		}
+		baked.shaderID = getDrawnShaderID(baked.shader);
+		baked.bindingTable = findBindingTable(material);
+		if (rebaked)
+			releaseBindingTable(previousTable);
+		baked.translucent = material.isFlagSet(Material::flag_tint) && material.getTint().a < 1.0f;
+		prepareShader(baked.shader);
+
+		s_data->dirtyBegin = std::min(s_data->dirtyBegin, index);
+		s_data->dirtyEnd = std::max(s_data->dirtyEnd, index + 1);
+	}
+
+	void Renderer3D::prepareShader(const std::shared_ptr<Shaders>& shader)
+	{
+		//setting anything on it would wait for the link, so a shader still compiling is set up when pollShaders sees it done.
+		if (shader->getStatus() == ShaderStatus::Compiling)
+		{
+			if (std::find(s_data->pendingShaders.begin(), s_data->pendingShaders.end(), shader) == s_data->pendingShaders.end())
+				s_data->pendingShaders.push_back(shader);
+			return;
+		}
+
+		if (!shader->isReady())
+			return;
+
+		//samplers are set on the program once, rather than every time it is bound.
+		shader->upload(shader->getUniform<int>("u_texData"), 0);
+		s_data->lightingUBO->attachShaderBlock(shader, "b_lights");
+	}
+
+	void Renderer3D::pollShaders()
+	{
+		auto& pending = s_data->pendingShaders;
+		for (uint32_t i = 0; i < pending.size();)
+		{
+			std::shared_ptr<Shaders> shader = pending[i];
+			if (shader->getStatus() == ShaderStatus::Compiling)
+			{
+				i++;
+				continue;
+			}
+
+			//linked, or failed and left on the fallback; either way it is done with.
+			pending[i] = pending.back();
+			pending.pop_back();
+			prepareShader(shader);
+
+			uint32_t shaderID = getDrawnShaderID(shader);
+			for (auto& material : s_data->materials)
+			{
+				if (material.shader == shader)
+					material.shaderID = shaderID;
+			}
+		}
+	}
+
+	uint32_t Renderer3D::getDrawnShaderID(const std::shared_ptr<Shaders>& shader)
+	{
+		if (shader->isReady())
+			return shader->getID();
+		if (s_data->fallbackShader)
+			return s_data->fallbackShader->getID();
+		return 0;
+	}
+
+	uint32_t Renderer3D::findBindingTable(const Material & material)
+	{
+		//a unit per slot; the diffuse unit always has something, so shaders that only sample it get white rather than nothing.
+		const uint32_t slotFlags[textureSlots] = { Material::flag_diffuseTexture, Material::flag_specularTexture, Material::flag_reflectionTexture, Material::flag_emmisiveTexture, Material::flag_normalTexture };
+		BindingTable table;
+		for (uint32_t slot = 0; slot < textureSlots; slot++)
+			table.textures[slot] = material.getTexture(slotFlags[slot]);
+		if (!table.textures[0] || material.isFlagSet(Material::flag_defaultTexture))
+			table.textures[0] = s_data->defaultTexture;
+		for (uint32_t slot = 0; slot < textureSlots; slot++)
+			table.IDs[slot] = table.textures[slot] ? table.textures[slot]->getID() : 0;
+
+		//materials with the same textures share a table, so they sort and batch together.
+		for (uint32_t i = 0; i < s_data->bindingTables.size(); i++)
+		{
+			BindingTable& existing = s_data->bindingTables[i];
+			if (existing.users > 0 && existing.IDs == table.IDs)
+			{
+				existing.users++;
+				return i;
+			}
+		}
+
+		//released tables are reused first, which keeps indices small for the sort key.
+		table.users = 1;
+		if (!s_data->freeBindingTables.empty())
+		{
+			uint32_t index = s_data->freeBindingTables.back();
+			s_data->freeBindingTables.pop_back();
+			s_data->bindingTables[index] = table;
+			return index;
+		}
+
+		s_data->bindingTables.push_back(table);
+		return s_data->bindingTables.size() - 1;
+	}
+
+	void Renderer3D::releaseBindingTable(uint32_t index)
+	{
+		BindingTable& table = s_data->bindingTables[index];
+		if (--table.users > 0)
+			return;
+
+		//the textures go with it, unless something else still holds them.
+		table = BindingTable();
+		s_data->freeBindingTables.push_back(index);
+	}
+
+	void Renderer3D::uploadMaterials()
+	{
+		if (s_data->materialParameters.empty())
+			return;
+
+		uint32_t neededSize = s_data->materialParameters.size() * sizeof(MaterialParameters);
+		if (!s_data->materialBuffer || s_data->materialBuffer->getSize() < neededSize)
+		{
+			//a new buffer twice the size takes everything, so materials can keep being added without growing it every time.
+			uint32_t size = std::max(neededSize, s_data->materialBuffer ? s_data->materialBuffer->getSize() * 2 : static_cast<uint32_t>(64 * sizeof(MaterialParameters)));
+			s_data->materialBuffer.reset(StorageBuffer::create(nullptr, size));
+			s_data->dirtyBegin = 0;
+			s_data->dirtyEnd = s_data->materialParameters.size();
+		}
+
+		if (s_data->dirtyBegin < s_data->dirtyEnd)
+		{
+			uint32_t offset = s_data->dirtyBegin * sizeof(MaterialParameters);
+			uint32_t size = (s_data->dirtyEnd - s_data->dirtyBegin) * sizeof(MaterialParameters);
+			s_data->materialBuffer->edit(&s_data->materialParameters[s_data->dirtyBegin], size, offset);
+			s_data->stats.materialBytes += size;
+			s_data->dirtyBegin = 0xFFFFFFFF;
+			s_data->dirtyEnd = 0;
+		}
+
+		OpenGLStateCache::bindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, s_data->materialBuffer->getID(), 0, s_data->materialBuffer->getSize());
 	}
 
 	void Renderer3D::begin(const SceneWideUniforms& sceneWideUniforms)
 	{
-		//bind that buffer to the cameraUBO.
-		glBindBuffer(GL_UNIFORM_BUFFER, s_data->cameraUBO->getID());
-		s_data->cameraUBO->uploadDataToBlock("u_projection", sceneWideUniforms.at("u_projection").second);
-		s_data->cameraUBO->uploadDataToBlock("u_view", sceneWideUniforms.at("u_view").second);
-
-		//bind that buffer to the lightingUBO.
-		glBindBuffer(GL_UNIFORM_BUFFER, s_data->lightingUBO->getID());
-		s_data->lightingUBO->uploadDataToBlock("u_lightPos", sceneWideUniforms.at("u_lightPos").second);
-		s_data->lightingUBO->uploadDataToBlock("u_viewPos", sceneWideUniforms.at("u_viewPos").second);
-		s_data->lightingUBO->uploadDataToBlock("u_lightColour", sceneWideUniforms.at("u_lightColour").second);
-	}
-
-	void Renderer3D::submit(const std::shared_ptr<VertexArray>& geometry, const std::shared_ptr<Material> material, const glm::mat4 & model)
-	{
-		//TO DO - to make API agnostic (below isn't, using opengl function), just put the bind functions into my classes. Need a shader bind function and VAO bind function, maybe submit render function too.
-		//first bind the shader.
-		glUseProgram(material->getShader()->getID());
-		
-		//apply the material uniforms (per draw uniforms).
-		material->getShader()->uploadMat4("u_model", model);		//everything will have a model applied, so do this here before checking.
-		
-		if (material->isFlagSet(Material::flag_defaultTexture))
-			glBindTexture(GL_TEXTURE_2D, s_data->defaultTexture->getID());
-		else if (material->isFlagSet(Material::flag_diffuseTexture))
-			glBindTexture(GL_TEXTURE_2D, material->getTexture(Material::flag_diffuseTexture)->getID());
-		else if (material->isFlagSet(Material::flag_specularTexture))
-			glBindTexture(GL_TEXTURE_2D, material->getTexture(Material::flag_specularTexture)->getID());
-		else if (material->isFlagSet(Material::flag_reflectionTexture))
-			glBindTexture(GL_TEXTURE_2D, material->getTexture(Material::flag_reflectionTexture)->getID());
-		else if (material->isFlagSet(Material::flag_emmisiveTexture))
-			glBindTexture(GL_TEXTURE_2D, material->getTexture(Material::flag_emmisiveTexture)->getID());
-		else if (material->isFlagSet(Material::flag_normalTexture))
-			glBindTexture(GL_TEXTURE_2D, material->getTexture(Material::flag_normalTexture)->getID());
-		else glBindTexture(GL_TEXTURE_2D, s_data->defaultTexture->getID());														
-		material->getShader()->uploadInt("u_texData", 0);
-
-		//now check whether the tint flag is set.
-		if (material->isFlagSet(Material::flag_tint))				
-			material->getShader()->uploadFloat4("u_tint", material->getTint());
+		//the lighting is laid out as the block is, checked at compile time, so it is copied over the block's CPU copy whole and whatever changed is sent in one upload.
+		//the padding is zeroed too, so an unchanged scene compares equal and nothing is sent.
+		LightingBlock lighting;
+		memset(&lighting, 0, sizeof(lighting));
+		lighting.lightPos = *static_cast<glm::vec3*>(sceneWideUniforms.at("u_lightPos").second);
+		lighting.viewPos = *static_cast<glm::vec3*>(sceneWideUniforms.at("u_viewPos").second);
+		lighting.lightColour = *static_cast<glm::vec3*>(sceneWideUniforms.at("u_lightColour").second);
+		s_data->lightingUBO->setBlock(lighting);
+		s_data->lightingUBO->upload();
+
+		//kept for sorting by distance.
+		s_data->viewPosition = *static_cast<glm::vec3*>(sceneWideUniforms.at("u_viewPos").second);
+
+		//the camera goes into every MVP rather than to the shaders, and gives the planes for culling.
+		glm::mat4 projection = *static_cast<glm::mat4*>(sceneWideUniforms.at("u_projection").second);
+		glm::mat4 view = *static_cast<glm::mat4*>(sceneWideUniforms.at("u_view").second);
+		s_data->viewProjection = projection * view;
+		s_data->projectionScale = projection[1][1];
+		s_data->frustum = Frustum(s_data->viewProjection);
+
+		s_data->drawItems.clear();
+		s_data->queue.clear();
+		s_data->stats = Renderer3DStats();
+
+		//shaders that finished compiling since last scene draw from this one on.
+		if (!s_data->pendingShaders.empty())
+			pollShaders();
+
+		//the section this scene writes to; waits only if the GPU is a whole ring behind.
+		s_data->drawData->beginFrame();
+	}
+
+	void Renderer3D::submit(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4 & model)
+	{
+		AABB bounds = getBounds(geometry);
+		record(geometry.get(), geometry->getDrawCount(), 0, 0, material, &model, 1, &bounds);
+	}
+
+	void Renderer3D::submitInstanced(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4 * models, uint32_t count)
+	{
+		AABB bounds = getBounds(geometry);
+		record(geometry.get(), geometry->getDrawCount(), 0, 0, material, models, count, &bounds);
+	}
+
+	void Renderer3D::submit(const std::shared_ptr<GeometryPool>& pool, const MeshRange & mesh, MaterialHandle material, const glm::mat4 & model)
+	{
+		if (mesh.lodCount <= 1)
+		{
+			record(pool->getVertexArray().get(), mesh.indexCount, mesh.firstIndex, mesh.firstVertex, material, &model, 1, &mesh.bounds);
+			return;
+		}
+
+		//nothing remembers which LOD a submit had last scene, so there is no hysteresis here; use addObject for that.
+		uint32_t lod = selectLOD(mesh.lods.data(), mesh.lodCount, getScreenSize(mesh.bounds, model), MeshRange::maxLODs);
+		record(pool->getVertexArray().get(), mesh.lods[lod].indexCount, mesh.lods[lod].firstIndex, mesh.firstVertex, material, &model, 1, &mesh.bounds);
+	}
+
+	void Renderer3D::submitInstanced(const std::shared_ptr<GeometryPool>& pool, const MeshRange & mesh, MaterialHandle material, const glm::mat4 * models, uint32_t count)
+	{
+		if (mesh.lodCount <= 1)
+		{
+			record(pool->getVertexArray().get(), mesh.indexCount, mesh.firstIndex, mesh.firstVertex, material, models, count, &mesh.bounds);
+			return;
+		}
+
+		//instances are split by LOD, each LOD an instanced draw of its own.
+		for (auto& lodModels : s_data->lodModels)
+			lodModels.clear();
+		for (uint32_t i = 0; i < count; i++)
+			s_data->lodModels[selectLOD(mesh.lods.data(), mesh.lodCount, getScreenSize(mesh.bounds, models[i]), MeshRange::maxLODs)].push_back(models[i]);
+		for (uint32_t lod = 0; lod < mesh.lodCount; lod++)
+			record(pool->getVertexArray().get(), mesh.lods[lod].indexCount, mesh.lods[lod].firstIndex, mesh.firstVertex, material, s_data->lodModels[lod].data(), s_data->lodModels[lod].size(), &mesh.bounds);
+	}
+
+	uint32_t Renderer3D::addObject(const std::shared_ptr<VertexArray>& geometry, MaterialHandle material, const glm::mat4 & model)
+	{
+		SceneObject object = { geometry, {}, 1, 0, 0, material, model, getBounds(geometry), AABBTree::nullNode };
+		object.lods[0] = { 0, geometry->getDrawCount(), FLT_MAX };
+		return addObject(object);
+	}
+
+	uint32_t Renderer3D::addObject(const std::shared_ptr<GeometryPool>& pool, const MeshRange & mesh, MaterialHandle material, const glm::mat4 & model)
+	{
+		SceneObject object = { pool->getVertexArray(), mesh.lods, std::max(mesh.lodCount, 1u), 0, mesh.firstVertex, material, model, mesh.bounds, AABBTree::nullNode };
+		object.lods[0] = { mesh.firstIndex, mesh.indexCount, FLT_MAX };
+		return addObject(object);
+	}
+
+	uint32_t Renderer3D::addObject(const SceneObject & object)
+	{
+		uint32_t id;
+		if (s_data->freeObjects.empty())
+		{
+			id = s_data->objects.size();
+			s_data->objects.push_back(object);
+		}
 		else
-			material->getShader()->uploadFloat4("u_tint", s_data->defaultTint);
+		{
+			id = s_data->freeObjects.back();
+			s_data->freeObjects.pop_back();
+			s_data->objects[id] = object;
+		}
+
+		SceneObject& added = s_data->objects[id];
+		if (added.localBounds.isValid())
+			added.proxy = s_data->objectTree.insert(added.localBounds.transformed(added.model), id);
+		else
+			s_data->unboundedObjects.push_back(id);
+
+		return id;
+	}
+
+	void Renderer3D::setObjectTransform(uint32_t object, const glm::mat4 & model)
+	{
+		if (object >= s_data->objects.size() || !s_data->objects[object].geometry)
+		{
+			Log::error("Renderer3D has no object {0} to move", object);
+			return;
+		}
+
+		SceneObject& moved = s_data->objects[object];
+		moved.model = model;
+		if (moved.proxy != AABBTree::nullNode)
+			s_data->objectTree.update(moved.proxy, moved.localBounds.transformed(model));
+	}
+
+	void Renderer3D::removeObject(uint32_t object)
+	{
+		if (object >= s_data->objects.size() || !s_data->objects[object].geometry)
+		{
+			Log::error("Renderer3D has no object {0} to remove", object);
+			return;
+		}
 
-		//bind geometry (VAO & IBO).
-		glBindVertexArray(geometry->getID());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->getIndexBuffer()->getID());
+		SceneObject& removed = s_data->objects[object];
+		if (removed.proxy != AABBTree::nullNode)
+			s_data->objectTree.remove(removed.proxy);
+		else
+			s_data->unboundedObjects.erase(std::find(s_data->unboundedObjects.begin(), s_data->unboundedObjects.end(), object));
 
-		//finally, submit the draw call.
-		glDrawElements(GL_TRIANGLES, geometry->getDrawCount(), GL_UNSIGNED_INT, nullptr);
+		//dropping the reference lets the geometry go if nothing else holds it.
+		removed = SceneObject();
+		s_data->freeObjects.push_back(object);
 	}
 
+	void Renderer3D::record(VertexArray* geometry, uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex, MaterialHandle material, const glm::mat4 * models, uint32_t count, const AABB* localBounds)
+	{
+		if (count == 0 || indexCount == 0)
+			return;
+
+		if (material.getIndex() >= s_data->materials.size() || !s_data->materials[material.getIndex()].shader)
+		{
+			Log::error("Renderer3D was given material {0}, which isn't baked", material.getIndex());
+			return;
+		}
+
+		//its shader is still compiling and there is nothing to stand in for it.
+		if (s_data->materials[material.getIndex()].shaderID == 0)
+		{
+			s_data->stats.waiting += count;
+			return;
+		}
+
+		//nothing is drawn yet, just recorded to be sorted at end(); the first model places it for sorting.
+		DrawItem item = { geometry, indexCount, firstIndex, baseVertex, material.getIndex(), static_cast<uint32_t>(s_data->instanceModels.size()), 0 };
+
+		if (localBounds && localBounds->isValid())
+		{
+			//only the instances that can be seen are kept, so an instanced draw shrinks rather than being all or nothing.
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (s_data->frustum.test(localBounds->transformed(models[i])) == FrustumTest::Outside)
+					continue;
+				s_data->instanceModels.push_back(models[i]);
+				item.instanceCount++;
+			}
+			s_data->stats.visible += item.instanceCount;
+			s_data->stats.culled += count - item.instanceCount;
+			if (item.instanceCount == 0)
+				return;
+		}
+		else
+		{
+			s_data->instanceModels.insert(s_data->instanceModels.end(), models, models + count);
+			item.instanceCount = count;
+		}
+
+		s_data->stats.triangles += item.indexCount / 3 * item.instanceCount;
+		if (count > 1)
+			s_data->stats.instances += item.instanceCount;
+
+		uint32_t index = s_data->drawItems.size();
+		s_data->queue.push(makeSortKey(item), index);
+		s_data->drawItems.push_back(std::move(item));
+	}
 
 	void Renderer3D::end()
 	{
+		//objects are recorded like submits, but the tree has already culled them.
+		AABBTreeQueryStats treeStats;
+		s_data->visibleObjects.clear();
+		s_data->objectTree.query(s_data->frustum, s_data->visibleObjects, treeStats);
+		s_data->stats.nodesTested = treeStats.nodesTested;
+		s_data->stats.visible += treeStats.visible;
+		s_data->stats.culled += (s_data->objects.size() - s_data->freeObjects.size() - s_data->unboundedObjects.size()) - treeStats.visible;
+		s_data->visibleObjects.insert(s_data->visibleObjects.end(), s_data->unboundedObjects.begin(), s_data->unboundedObjects.end());
+
+		for (uint32_t id : s_data->visibleObjects)
+		{
+			SceneObject& object = s_data->objects[id];
+			if (object.lodCount > 1)
+				object.lod = selectLOD(object.lods.data(), object.lodCount, getScreenSize(object.localBounds, object.model), object.lod);
+
+			const MeshLOD& lod = object.lods[object.lod];
+			record(object.geometry.get(), lod.indexCount, lod.firstIndex, object.baseVertex, object.material, &object.model, 1, nullptr);
+		}
+
+		s_data->queue.sort();
+		uploadMaterials();
+
+		uint32_t commandOffset = 0;
+		if (writeFrameData(commandOffset))
+		{
+			const auto& entries = s_data->queue.getEntries();
+			uint32_t batchStart = 0;
+			while (batchStart < entries.size())
+			{
+				const DrawItem& first = s_data->drawItems[entries[batchStart].index];
+				const BakedMaterial& material = s_data->materials[first.material];
+
+				//a batch is every following item that needs no state changed; the sort put them next to each other.
+				uint32_t batchEnd = batchStart + 1;
+				while (batchEnd < entries.size())
+				{
+					const DrawItem& item = s_data->drawItems[entries[batchEnd].index];
+					const BakedMaterial& itemMaterial = s_data->materials[item.material];
+					if (itemMaterial.shaderID != material.shaderID || itemMaterial.bindingTable != material.bindingTable || item.geometry->getID() != first.geometry->getID())
+						break;
+					batchEnd++;
+				}
+
+				//TO DO - to make API agnostic (below isn't, using opengl function), just put the bind functions into my classes. Need a shader bind function and VAO bind function, maybe submit render function too.
+				//the state cache drops whatever is already bound, the counters here are for what changed between batches.
+				const DrawItem* previous = batchStart == 0 ? nullptr : &s_data->drawItems[entries[batchStart - 1].index];
+				const BakedMaterial* previousMaterial = previous ? &s_data->materials[previous->material] : nullptr;
+				if (!previous || material.shaderID != previousMaterial->shaderID)
+				{
+					OpenGLStateCache::useProgram(material.shaderID);
+					s_data->stats.shaderBinds++;
+				}
+
+				//every unit is set, empty ones to 0, so nothing is left over from the previous batch's table.
+				if (!previous || material.bindingTable != previousMaterial->bindingTable)
+				{
+					const BindingTable& table = s_data->bindingTables[material.bindingTable];
+					for (uint32_t slot = 0; slot < textureSlots; slot++)
+						OpenGLStateCache::bindTextureUnit(slot, table.IDs[slot]);
+					s_data->stats.textureBinds++;
+				}
+
+				if (!previous || first.geometry->getID() != previous->geometry->getID())
+				{
+					OpenGLStateCache::bindVertexArray(first.geometry->getID());
+					s_data->stats.VAOBinds++;
+				}
+
+				//one call for the whole batch; each command has its own index range, base vertex and draw data.
+				uint32_t batchCount = batchEnd - batchStart;
+				glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(uintptr_t)(commandOffset + batchStart * sizeof(DrawCommand)), batchCount, 0);
+				s_data->stats.draws++;
+				s_data->stats.commands += batchCount;
+
+				batchStart = batchEnd;
+			}
+		}
+
+		//the GPU is done with this scene's section once these draws are.
+		s_data->drawData->endFrame();
+
+		s_data->drawItems.clear();
+		s_data->queue.clear();
 		s_data->sceneWideUniforms.clear();
+		s_data->instanceModels.clear();
+		s_data->sortedModels.clear();
+		s_data->sortedMaterials.clear();
+	}
+
+	bool Renderer3D::writeFrameData(uint32_t& commandOffset)
+	{
+		uint32_t drawDataSize = s_data->instanceModels.size() * sizeof(DrawData);
+		uint32_t commandSize = s_data->drawItems.size() * sizeof(DrawCommand);
+		if (commandSize == 0)
+			return false;
+
+		uint32_t drawDataOffset;
+		DrawData* drawData = static_cast<DrawData*>(s_data->drawData->allocate(drawDataSize, drawDataOffset));
+		DrawCommand* commands = drawData ? static_cast<DrawCommand*>(s_data->drawData->allocate(commandSize, commandOffset)) : nullptr;
+		if (!commands)
+		{
+			//too much for a section; a new ring twice the size (or big enough, with room for alignment) replaces it. The old one is deleted here, which
+			//is safe with draws still reading it, as GL keeps a deleted buffer's storage until the commands already issued against it are done.
+			uint32_t frameSize = std::max(drawDataSize + commandSize + 1024, s_data->drawData->getFrameSize() * 2);
+			Log::info("Renderer3D draw data ring buffer grown to {0} bytes per frame", frameSize);
+			s_data->drawData.reset(RingBuffer::create(frameSize));
+			s_data->drawData->beginFrame();
+			drawData = static_cast<DrawData*>(s_data->drawData->allocate(drawDataSize, drawDataOffset));
+			commands = drawData ? static_cast<DrawCommand*>(s_data->drawData->allocate(commandSize, commandOffset)) : nullptr;
+			if (!commands)
+				return false;
+		}
+
+		//models and materials are put in draw order first, so the transform stage reads them in order and never reads back the mapped buffer.
+		s_data->sortedModels.clear();
+		s_data->sortedMaterials.clear();
+		uint32_t command = 0;
+		for (const auto& entry : s_data->queue.getEntries())
+		{
+			DrawItem& item = s_data->drawItems[entry.index];
+
+			uint32_t instance = s_data->sortedModels.size();
+			s_data->sortedModels.insert(s_data->sortedModels.end(), s_data->instanceModels.begin() + item.firstInstance, s_data->instanceModels.begin() + item.firstInstance + item.instanceCount);
+			s_data->sortedMaterials.insert(s_data->sortedMaterials.end(), item.instanceCount, item.material);
+
+			commands[command++] = { item.indexCount, item.instanceCount, item.firstIndex, static_cast<int32_t>(item.baseVertex), instance };
+		}
+
+		//each range of instances writes its own part of the buffer, so big scenes split across the workers with nothing shared.
+		const glm::mat4* models = s_data->sortedModels.data();
+		const uint32_t* materials = s_data->sortedMaterials.data();
+		uint32_t instanceCount = s_data->sortedModels.size();
+		if (instanceCount >= parallelTransformCount && JobSystem::getWorkerCount() > 0)
+		{
+			JobSystem::parallelFor((instanceCount + 3) / 4, [models, materials, instanceCount, drawData](uint32_t begin, uint32_t end)
+			{
+				uint32_t first = begin * 4;
+				uint32_t last = std::min(end * 4, instanceCount);
+				transformInstances(models + first, materials + first, last - first, s_data->viewProjection, drawData + first);
+			});
+		}
+		else
+			transformInstances(models, materials, instanceCount, s_data->viewProjection, drawData);
+
+		OpenGLStateCache::bindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, s_data->drawData->getID(), drawDataOffset, drawDataSize);
+		OpenGLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, s_data->drawData->getID());
+		s_data->stats.drawDataBytes = drawDataSize + commandSize;
+		return true;
+	}
+
+	void Renderer3D::transformInstances(const glm::mat4 * models, const uint32_t * materials, uint32_t count, const glm::mat4 & viewProjection, DrawData * drawData)
+	{
+		//every element of the view projection in every lane, so four models multiply by it at once.
+		__m128 vp[4][4];
+		for (uint32_t c = 0; c < 4; c++)
+			for (uint32_t r = 0; r < 4; r++)
+				vp[c][r] = _mm_set1_ps(viewProjection[c][r]);
+
+		for (uint32_t i = 0; i < count; i += 4)
+		{
+			//a short last batch is padded with identities, which are worked out and then not written.
+			uint32_t lanes = std::min(4u, count - i);
+			const glm::mat4* batch = models + i;
+			glm::mat4 padded[4];
+			if (lanes < 4)
+			{
+				for (uint32_t l = 0; l < 4; l++)
+					padded[l] = l < lanes ? models[i + l] : glm::mat4(1.0f);
+				batch = padded;
+			}
+
+			//to SoA; m[c][r] is element r of column c of all four models, a lane each.
+			__m128 m[4][4];
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				for (uint32_t l = 0; l < 4; l++)
+					m[c][l] = _mm_loadu_ps(&batch[l][c][0]);
+				_MM_TRANSPOSE4_PS(m[c][0], m[c][1], m[c][2], m[c][3]);
+			}
+
+			//MVP[c][r] = sum over k of VP[k][r] * M[c][k].
+			__m128 mvp[4][4];
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				for (uint32_t r = 0; r < 4; r++)
+				{
+					mvp[c][r] = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(vp[0][r], m[c][0]), _mm_mul_ps(vp[1][r], m[c][1])),
+						_mm_add_ps(_mm_mul_ps(vp[2][r], m[c][2]), _mm_mul_ps(vp[3][r], m[c][3])));
+				}
+			}
+
+			//the inverse transpose of the upper 3x3 has columns c1 x c2, c2 x c0 and c0 x c1, over the determinant.
+			__m128 normal[3][4];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				const __m128* a = m[(c + 1) % 3];
+				const __m128* b = m[(c + 2) % 3];
+				normal[c][0] = _mm_sub_ps(_mm_mul_ps(a[1], b[2]), _mm_mul_ps(a[2], b[1]));
+				normal[c][1] = _mm_sub_ps(_mm_mul_ps(a[2], b[0]), _mm_mul_ps(a[0], b[2]));
+				normal[c][2] = _mm_sub_ps(_mm_mul_ps(a[0], b[1]), _mm_mul_ps(a[1], b[0]));
+				normal[c][3] = _mm_setzero_ps();
+			}
+			__m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][0], normal[0][0]), _mm_mul_ps(m[0][1], normal[0][1])), _mm_mul_ps(m[0][2], normal[0][2]));
+			__m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+			for (uint32_t c = 0; c < 3; c++)
+				for (uint32_t r = 0; r < 3; r++)
+					normal[c][r] = _mm_mul_ps(normal[c][r], inverseDeterminant);
+
+			//back to AoS, a column of each model per register.
+			for (uint32_t c = 0; c < 4; c++)
+				_MM_TRANSPOSE4_PS(mvp[c][0], mvp[c][1], mvp[c][2], mvp[c][3]);
+			for (uint32_t c = 0; c < 3; c++)
+				_MM_TRANSPOSE4_PS(normal[c][0], normal[c][1], normal[c][2], normal[c][3]);
+
+			//written in order, a whole instance at a time, as the buffer is write combined.
+			for (uint32_t l = 0; l < lanes; l++)
+			{
+				DrawData& out = drawData[i + l];
+				out.model = batch[l];
+				for (uint32_t c = 0; c < 4; c++)
+					_mm_storeu_ps(&out.MVP[c][0], mvp[c][l]);
+				for (uint32_t c = 0; c < 3; c++)
+					_mm_storeu_ps(&out.normalMatrix[c][0], normal[c][l]);
+				out.material = materials[i + l];
+			}
+		}
+	}
+
+	float Renderer3D::getScreenSize(const AABB & localBounds, const glm::mat4 & model)
+	{
+		if (!localBounds.isValid())
+			return FLT_MAX;
+
+		//the bounding sphere of the box, scaled by the largest scale in the model.
+		glm::vec3 centre = glm::vec3(model * glm::vec4(localBounds.getCentre(), 1.0f));
+		float scale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+		float radius = glm::length(localBounds.getExtents()) * scale;
+
+		//radius over half the screen height; the camera inside the sphere sees it fill the screen.
+		float distance = glm::length(centre - s_data->viewPosition);
+		if (distance <= radius)
+			return FLT_MAX;
+		return radius * s_data->projectionScale / distance;
+	}
+
+	uint32_t Renderer3D::selectLOD(const MeshLOD * lods, uint32_t lodCount, float screenSize, uint32_t current)
+	{
+		//the coarsest LOD the size allows.
+		uint32_t lod = 0;
+		while (lod + 1 < lodCount && screenSize < lods[lod + 1].screenSize)
+			lod++;
+
+		if (current >= lodCount || lod == current)
+			return lod;
+
+		//only leave the current LOD once the size is clearly past the threshold, so something sat on it doesn't flicker between two.
+		if (lod > current)
+		{
+			while (lod > current && screenSize > lods[lod].screenSize * (1.0f - lodHysteresis))
+				lod--;
+		}
+		else if (screenSize < lods[current].screenSize * (1.0f + lodHysteresis))
+			lod = current;
+
+		return lod;
+	}
+
+	AABB Renderer3D::getBounds(const std::shared_ptr<VertexArray>& geometry)
+	{
+		//a buffer without positions leaves the whole thing unbounded, so it's never wrongly culled.
+		AABB bounds;
+		for (const auto& vertexBuffer : geometry->getVertexBuffer())
+		{
+			if (!vertexBuffer->getBounds().isValid())
+				return AABB();
+			bounds.grow(vertexBuffer->getBounds());
+		}
+		return bounds;
+	}
+
+	uint64_t Renderer3D::makeSortKey(const DrawItem & item)
+	{
+		/* from the top bit down:
+		* translucent	1 bit
+		* opaque:		shader 8 bits, binding table 12 bits, VAO 12 bits, depth 31 bits; state first, then nearest first.
+		* translucent:	depth 31 bits (inverted), shader 8 bits, binding table 12 bits, VAO 12 bits; furthest first so they blend properly.
+		* the material itself isn't state, its parameters are indexed per instance, so different materials with the same shader and textures batch together.
+		*/
+		const BakedMaterial& material = s_data->materials[item.material];
+		uint64_t state = (static_cast<uint64_t>(material.shaderID & 0xFF) << 24) |
+			(static_cast<uint64_t>(material.bindingTable & 0xFFF) << 12) |
+			static_cast<uint64_t>(item.geometry->getID() & 0xFFF);
+
+		//squared distance to the camera; positive floats order the same as their bits, so the bits below the sign are the depth.
+		glm::vec3 toCamera = glm::vec3(s_data->instanceModels[item.firstInstance][3]) - s_data->viewPosition;
+		float distance = glm::dot(toCamera, toCamera);
+		uint32_t distanceBits;
+		memcpy(&distanceBits, &distance, sizeof(float));
+		uint64_t depth = distanceBits & 0x7FFFFFFF;
+
+		if (material.translucent)
+			return (1ull << 63) | ((~depth & 0x7FFFFFFF) << 32) | state;
+		else
+			return (state << 31) | depth;
 	}
 
 	void Renderer3D::attachShader(std::shared_ptr<Shaders> shader)
 	{
-		//attach them pesky shaders!
-		s_data->cameraUBO->attachShaderBlock(shader, "b_camera");
-		s_data->lightingUBO->attachShaderBlock(shader, "b_lights");
+		//attach them pesky shaders! the camera is already in each instance's MVP.
+		prepareShader(shader);
+	}
+
+	void Renderer3D::setFallbackShader(std::shared_ptr<Shaders> shader)
+	{
+		//a fallback has to be there when it's needed, so this is the one place a compile is waited on.
+		shader->wait();
+		s_data->fallbackShader = shader;
+		prepareShader(shader);
+
+		for (auto& material : s_data->materials)
+		{
+			if (material.shader)
+				material.shaderID = getDrawnShaderID(material.shader);
+		}
+	}
+
+	std::vector<std::string> Material::getDefines(uint32_t flags)
+	{
+		const std::pair<uint32_t, const char*> flagDefines[] = {
+			{ flag_diffuseTexture, "MATERIAL_DIFFUSE_TEXTURE" },
+			{ flag_specularTexture, "MATERIAL_SPECULAR_TEXTURE" },
+			{ flag_reflectionTexture, "MATERIAL_REFLECTION_TEXTURE" },
+			{ flag_emmisiveTexture, "MATERIAL_EMMISIVE_TEXTURE" },
+			{ flag_normalTexture, "MATERIAL_NORMAL_TEXTURE" },
+			{ flag_defaultTexture, "MATERIAL_DEFAULT_TEXTURE" },
+			{ flag_tint, "MATERIAL_TINT" }
+		};
+
+		std::vector<std::string> defines;
+		for (const auto& flagDefine : flagDefines)
+		{
+			if (flags & flagDefine.first)
+				defines.push_back(flagDefine.second);
+		}
+		return defines;
 	}
 
 	inline std::shared_ptr<Textures> Material::getTexture(uint32_t textureFlag) const
@@ -0,0 +1,50 @@
+/** \file shaderVariants.cpp */
+
+#include "engine_pch.h"
+#include "renderer/shaderVariants.h"
+#include "rendering/shaderPreprocessor.h"
+#include "systems/generalFunctions.h"
+#include <algorithm>
+
+namespace Engine
+{
+	std::unordered_map<uint64_t, std::weak_ptr<Shaders>> ShaderVariants::s_variants;
+
+	ShaderVariants::ShaderVariants(const char * filePath) :
+		m_filePath(filePath)
+	{
+		//a source that can't be read is reported here, and again by each variant that tries to compile it.
+		std::string source;
+		ShaderPreprocessor::load(filePath, source);
+		m_sourceHash = GenFuncs::hash(source.data(), source.size());
+	}
+
+	std::shared_ptr<Shaders> ShaderVariants::get(std::vector<std::string> defines)
+	{
+		//the same defines in a different order are the same variant.
+		std::sort(defines.begin(), defines.end());
+		uint64_t key = m_sourceHash;
+		for (const auto& define : defines)
+			key = GenFuncs::hash(define.c_str(), key);
+
+		auto it = s_variants.find(key);
+		if (it != s_variants.end())
+		{
+			if (std::shared_ptr<Shaders> variant = it->second.lock())
+				return variant;
+		}
+
+		//a miss is rare, so it is when entries whose variants nothing uses any more are cleared out.
+		for (auto entry = s_variants.begin(); entry != s_variants.end();)
+		{
+			if (entry->second.expired())
+				entry = s_variants.erase(entry);
+			else
+				++entry;
+		}
+
+		std::shared_ptr<Shaders> variant(Shaders::createAsync(m_filePath.c_str(), defines));
+		s_variants[key] = variant;
+		return variant;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/** \file textRunCache.cpp */
+
+#include "engine_pch.h"
+#include "renderer/textRunCache.h"
+#include "systems/log.h"
+
+namespace Engine
+{
+	TextRunCache::TextRunCache(const std::shared_ptr<GlyphAtlas>& atlas, uint32_t maxUnusedFrames) :
+		m_atlas(atlas),
+		m_maxUnusedFrames(maxUnusedFrames)
+	{
+	}
+
+	const TextRun & TextRunCache::getRun(const char * text, FT_Face face, uint32_t pixelSize)
+	{
+		RunKey key = { text, face, pixelSize };
+
+		auto it = m_runs.find(key);
+		if (it == m_runs.end())
+		{
+			//first time this string has been seen at this size, so lay it out.
+			it = m_runs.emplace(std::move(key), TextRun()).first;
+			layout(it->second, text, face, pixelSize);
+		}
+
+		it->second.lastUsedFrame = m_frame;
+		return it->second;
+	}
+
+	void TextRunCache::endFrame()
+	{
+		m_frame++;
+
+		//sweep every so often rather than every frame.
+		if (m_frame % m_maxUnusedFrames != 0)
+			return;
+
+		for (auto it = m_runs.begin(); it != m_runs.end();)
+		{
+			if (m_frame - it->second.lastUsedFrame > m_maxUnusedFrames)
+				it = m_runs.erase(it);
+			else
+				++it;
+		}
+	}
+
+	size_t TextRunCache::RunKeyHash::operator()(const RunKey & key) const
+	{
+		size_t hash = std::hash<std::string>()(key.text);
+		hash ^= std::hash<void*>()(key.face) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<uint32_t>()(key.pixelSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	void TextRunCache::layout(TextRun & run, const char * text, FT_Face face, uint32_t pixelSize)
+	{
+		//kerning is given for whatever size the face is set to, so make sure it's this one.
+		if (FT_Set_Pixel_Sizes(face, 0, pixelSize))
+			Log::error("ERROR: font size NOT set: {0}", pixelSize);
+
+		bool hasKerning = FT_HAS_KERNING(face);
+		FT_UInt previousIndex = 0;
+		float x = 0.0f;
+
+		for (const char* ch = text; *ch != '\0'; ch++)
+		{
+			uint32_t codepoint = static_cast<unsigned char>(*ch);
+			const GlyphInfo& glyph = m_atlas->getGlyph(face, pixelSize, codepoint);
+
+			//kerning between this glyph and the last.
+			FT_UInt glyphIndex = FT_Get_Char_Index(face, codepoint);
+			if (hasKerning && previousIndex && glyphIndex)
+			{
+				FT_Vector delta;
+				if (!FT_Get_Kerning(face, previousIndex, glyphIndex, FT_KERNING_DEFAULT, &delta))
+					x += static_cast<float>(delta.x >> 6);
+			}
+			previousIndex = glyphIndex;
+
+			//nothing to draw for spaces etc, but they still advance the pen.
+			if (glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+			{
+				TextRunGlyph runGlyph;
+				runGlyph.min = glm::vec2(x, 0.0f) + glyph.bearing;
+				runGlyph.max = runGlyph.min + glyph.size;
+				runGlyph.UVStart = glyph.UVStart;
+				runGlyph.UVEnd = glyph.UVEnd;
+				run.glyphs.push_back(runGlyph);
+
+				//grow the bounds, starting them from the first glyph.
+				run.boundsMin = (run.glyphs.size() == 1) ? runGlyph.min : glm::min(run.boundsMin, runGlyph.min);
+				run.boundsMax = (run.glyphs.size() == 1) ? runGlyph.max : glm::max(run.boundsMax, runGlyph.max);
+			}
+
+			x += glyph.advance;
+		}
+
+		run.width = x;
+	}
+}
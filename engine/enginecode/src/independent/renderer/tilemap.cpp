@@ -0,0 +1,193 @@
+/** \file tilemap.cpp */
+
+#include "engine_pch.h"
+#include "renderer/tilemap.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "systems/generalFunctions.h"
+#include <algorithm>
+
+namespace Engine
+{
+	//initialise static variables.
+	VertexBufferLayout TilemapVertex::s_BufferLayout = VertexBufferLayout({ { ShaderDataType::Short2, true }, ShaderDataType::Byte2 }, sizeof(TilemapVertex));
+
+	Tilemap::Tilemap(uint32_t width, uint32_t height, float tileSize, const std::shared_ptr<Textures>& tileset, uint32_t tilesetColumns, uint32_t tilesetRows) :
+		m_width(width),
+		m_height(height),
+		m_tileSize(tileSize),
+		m_tileset(tileset),
+		m_tilesetColumns(tilesetColumns),
+		m_tilesetRows(tilesetRows),
+		m_tiles(width * height, 0),
+		m_chunksX((width + chunkSize - 1) / chunkSize),
+		m_chunksY((height + chunkSize - 1) / chunkSize)
+	{
+		//chunks are only given buffers when they are first baked, so a big map costs nothing until it is looked at.
+		m_chunks.resize(m_chunksX * m_chunksY);
+		m_bakeBuffer.resize(chunkSize * chunkSize * 4);
+
+		//every chunk has the same index pattern, so one index buffer does for all of them.
+		std::vector<uint32_t> indices(chunkSize * chunkSize * 6);
+		for (uint32_t i = 0; i < chunkSize * chunkSize; i++)
+		{
+			indices[i * 6 + 0] = i * 4 + 0;
+			indices[i * 6 + 1] = i * 4 + 1;
+			indices[i * 6 + 2] = i * 4 + 2;
+			indices[i * 6 + 3] = i * 4 + 2;
+			indices[i * 6 + 4] = i * 4 + 3;
+			indices[i * 6 + 5] = i * 4 + 0;
+		}
+		m_IBO.reset(IndexBuffer::create(indices.data(), indices.size()));
+
+		m_shader.reset(Shaders::create("./assets/shaders/tilemap.glsl"));
+		m_tileSizeUniform = m_shader->getUniform<float>("u_tileSize");
+		m_tilesetUniform = m_shader->getUniform<int>("u_tileset");
+		m_chunkOriginUniform = m_shader->getUniform<glm::vec2>("u_chunkOrigin");
+	}
+
+	void Tilemap::setTile(uint32_t x, uint32_t y, uint16_t tile)
+	{
+		if (x >= m_width || y >= m_height)
+		{
+			Log::error("Tile out of range of the tilemap: {0}, {1}", x, y);
+			return;
+		}
+
+		uint16_t& current = m_tiles[y * m_width + x];
+		if (current == tile)
+			return;
+
+		//only the chunk the tile is in needs baking again.
+		current = tile;
+		m_chunks[(y / chunkSize) * m_chunksX + (x / chunkSize)].dirty = true;
+	}
+
+	uint16_t Tilemap::getTile(uint32_t x, uint32_t y) const
+	{
+		if (x >= m_width || y >= m_height)
+			return 0;
+
+		return m_tiles[y * m_width + x];
+	}
+
+	void Tilemap::draw(const SceneWideUniforms& swu, const glm::vec2& viewMin, const glm::vec2& viewMax)
+	{
+		m_stats = TilemapStats();
+
+		//range of chunks the view overlaps; only these are ever looked at.
+		float chunkWorldSize = chunkSize * m_tileSize;
+		int32_t firstX = std::max(static_cast<int32_t>(floor(viewMin.x / chunkWorldSize)), 0);
+		int32_t firstY = std::max(static_cast<int32_t>(floor(viewMin.y / chunkWorldSize)), 0);
+		int32_t lastX = std::min(static_cast<int32_t>(floor(viewMax.x / chunkWorldSize)), static_cast<int32_t>(m_chunksX) - 1);
+		int32_t lastY = std::min(static_cast<int32_t>(floor(viewMax.y / chunkWorldSize)), static_cast<int32_t>(m_chunksY) - 1);
+
+		if (firstX > lastX || firstY > lastY)
+			return;
+
+		OpenGLStateCache::useProgram(m_shader->getID());
+
+		//apply scene wide uniforms to the shader.
+		for (auto& dataPair : swu)
+		{
+			const char* uniformName = dataPair.first;
+			ShaderDataType sdt = dataPair.second.first;
+			void * addressValue = dataPair.second.second;
+
+			switch (sdt)
+			{
+			case ShaderDataType::Int:
+				m_shader->uploadInt(uniformName, *(int *)addressValue);
+				break;
+			case ShaderDataType::Float3:
+				m_shader->uploadFloat3(uniformName, *(glm::vec3 *)addressValue);
+				break;
+			case ShaderDataType::Float4:
+				m_shader->uploadFloat4(uniformName, *(glm::vec4 *)addressValue);
+				break;
+			case ShaderDataType::Mat4:
+				m_shader->uploadMat4(uniformName, *(glm::mat4 *)addressValue);
+				break;
+			}
+		}
+
+		m_shader->upload(m_tileSizeUniform, m_tileSize);
+		m_shader->upload(m_tilesetUniform, 0);
+		OpenGLStateCache::bindTextureUnit(0, m_tileset->getID());
+
+		for (int32_t chunkY = firstY; chunkY <= lastY; chunkY++)
+		{
+			for (int32_t chunkX = firstX; chunkX <= lastX; chunkX++)
+			{
+				Chunk& chunk = m_chunks[chunkY * m_chunksX + chunkX];
+				if (chunk.dirty)
+				{
+					bake(chunkX, chunkY);
+					m_stats.chunksRebuilt++;
+				}
+
+				if (chunk.tileCount == 0)
+					continue;
+
+				m_shader->upload(m_chunkOriginUniform, glm::vec2(chunkX, chunkY) * chunkWorldSize);
+				OpenGLStateCache::bindVertexArray(chunk.VAO->getID());
+				glDrawElements(GL_TRIANGLES, chunk.tileCount * 6, GL_UNSIGNED_INT, nullptr);
+
+				m_stats.chunksDrawn++;
+				m_stats.tilesDrawn += chunk.tileCount;
+			}
+		}
+	}
+
+	void Tilemap::bake(uint32_t chunkX, uint32_t chunkY)
+	{
+		Chunk& chunk = m_chunks[chunkY * m_chunksX + chunkX];
+
+		//first bake, so make the buffers; sized for a full chunk so later bakes never reallocate.
+		if (!chunk.VAO)
+		{
+			chunk.VAO.reset(VertexArray::create());
+			chunk.VBO.reset(VertexBuffer::create(nullptr, sizeof(TilemapVertex) * m_bakeBuffer.size(), TilemapVertex::getBufferLayout()));
+			chunk.VAO->addVertexBuffer(chunk.VBO);
+			chunk.VAO->setIndexBuffer(m_IBO);
+		}
+
+		glm::vec2 cellSize(1.0f / m_tilesetColumns, 1.0f / m_tilesetRows);
+		uint32_t count = 0;
+
+		for (uint32_t y = 0; y < chunkSize; y++)
+		{
+			uint32_t tileY = chunkY * chunkSize + y;
+			if (tileY >= m_height)
+				break;
+
+			for (uint32_t x = 0; x < chunkSize; x++)
+			{
+				uint32_t tileX = chunkX * chunkSize + x;
+				if (tileX >= m_width)
+					break;
+
+				//empty tiles aren't baked at all.
+				uint16_t tile = m_tiles[tileY * m_width + tileX];
+				if (tile == 0)
+					continue;
+
+				glm::vec2 UVStart = glm::vec2((tile - 1) % m_tilesetColumns, (tile - 1) / m_tilesetColumns) * cellSize;
+				glm::vec2 UVEnd = UVStart + cellSize;
+
+				//corners in the same order as the 2D batch.
+				TilemapVertex* vertex = &m_bakeBuffer[count * 4];
+				vertex[0] = TilemapVertex(GenFuncs::normalise(glm::vec2(UVStart.x, UVStart.y)), x, y);
+				vertex[1] = TilemapVertex(GenFuncs::normalise(glm::vec2(UVStart.x, UVEnd.y)), x, y + 1);
+				vertex[2] = TilemapVertex(GenFuncs::normalise(glm::vec2(UVEnd.x, UVEnd.y)), x + 1, y + 1);
+				vertex[3] = TilemapVertex(GenFuncs::normalise(glm::vec2(UVEnd.x, UVStart.y)), x + 1, y);
+				count++;
+			}
+		}
+
+		if (count > 0)
+			chunk.VBO->edit(m_bakeBuffer.data(), sizeof(TilemapVertex) * count * 4, 0);
+
+		chunk.tileCount = count;
+		chunk.dirty = false;
+	}
+}
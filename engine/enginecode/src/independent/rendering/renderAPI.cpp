@@ -11,6 +11,8 @@
 #include "platform/OpenGL/OpenGLShader.h"
 #include "platform/OpenGL/OpenGLTexture.h"
 #include "platform/OpenGL/OpenGLUniformBuffer.h"
+#include "platform/OpenGL/OpenGLRingBuffer.h"
+#include "platform/OpenGL/OpenGLStorageBuffer.h"
 
 
 namespace Engine
@@ -106,7 +108,7 @@ namespace Engine
 		return nullptr;
 	}
 
-	Shaders* Shaders::create(const char* filePath)
+	Shaders* Shaders::create(const char* filePath, const std::vector<std::string>& defines)
 	{
 		switch (RenderAPI::getAPI())
 		{
@@ -114,7 +116,51 @@ namespace Engine
 			Log::error("No rendering API; not supported, SORT IT OUT!");
 			break;
 		case RenderAPI::API::OpenGL:
-			return new OpenGLShader(filePath);
+			return new OpenGLShader(filePath, defines);
+
+		case RenderAPI::API::Direct3D:
+			Log::error("DIRECT3D rendering API is not supported at this time.");
+			break;
+		case RenderAPI::API::Vulkan:
+			Log::error("VULKAN rendering API is not supported at this time.");
+			break;
+		}
+
+		//otherwise return nullptr.
+		return nullptr;
+	}
+
+	Shaders* Shaders::createAsync(const char* vertexFilePath, const char* fragmentFilePath)
+	{
+		switch (RenderAPI::getAPI())
+		{
+		case RenderAPI::API::None:
+			Log::error("No rendering API; not supported, SORT IT OUT!");
+			break;
+		case RenderAPI::API::OpenGL:
+			return new OpenGLShader(vertexFilePath, fragmentFilePath, true);
+
+		case RenderAPI::API::Direct3D:
+			Log::error("DIRECT3D rendering API is not supported at this time.");
+			break;
+		case RenderAPI::API::Vulkan:
+			Log::error("VULKAN rendering API is not supported at this time.");
+			break;
+		}
+
+		//otherwise return nullptr.
+		return nullptr;
+	}
+
+	Shaders* Shaders::createAsync(const char* filePath, const std::vector<std::string>& defines)
+	{
+		switch (RenderAPI::getAPI())
+		{
+		case RenderAPI::API::None:
+			Log::error("No rendering API; not supported, SORT IT OUT!");
+			break;
+		case RenderAPI::API::OpenGL:
+			return new OpenGLShader(filePath, defines, true);
 
 		case RenderAPI::API::Direct3D:
 			Log::error("DIRECT3D rendering API is not supported at this time.");
@@ -193,4 +239,48 @@ namespace Engine
 		//otherwise return nullptr.
 		return nullptr;
 	}
+
+	RingBuffer* RingBuffer::create(uint32_t frameSize, uint32_t frameCount)
+	{
+		switch (RenderAPI::getAPI())
+		{
+		case RenderAPI::API::None:
+			Log::error("No rendering API; not supported, SORT IT OUT!");
+			break;
+		case RenderAPI::API::OpenGL:
+			return new OpenGLRingBuffer(frameSize, frameCount);
+
+		case RenderAPI::API::Direct3D:
+			Log::error("DIRECT3D rendering API is not supported at this time.");
+			break;
+		case RenderAPI::API::Vulkan:
+			Log::error("VULKAN rendering API is not supported at this time.");
+			break;
+		}
+
+		//otherwise return nullptr.
+		return nullptr;
+	}
+
+	StorageBuffer* StorageBuffer::create(const void* data, uint32_t size)
+	{
+		switch (RenderAPI::getAPI())
+		{
+		case RenderAPI::API::None:
+			Log::error("No rendering API; not supported, SORT IT OUT!");
+			break;
+		case RenderAPI::API::OpenGL:
+			return new OpenGLStorageBuffer(data, size);
+
+		case RenderAPI::API::Direct3D:
+			Log::error("DIRECT3D rendering API is not supported at this time.");
+			break;
+		case RenderAPI::API::Vulkan:
+			Log::error("VULKAN rendering API is not supported at this time.");
+			break;
+		}
+
+		//otherwise return nullptr.
+		return nullptr;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/** \file shaderPreprocessor.cpp */
+
+#include "engine_pch.h"
+#include "rendering/shaderPreprocessor.h"
+#include "systems/log.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace Engine
+{
+	bool ShaderPreprocessor::load(const char * filePath, std::string & source)
+	{
+		std::vector<std::string> including;
+		source.clear();
+		return append(filePath, source, including);
+	}
+
+	std::string ShaderPreprocessor::addDefines(const std::string & source, const std::vector<std::string>& defines)
+	{
+		if (defines.empty())
+			return source;
+
+		//#version has to come first, and a single file has one per region, so every one gets the defines after it.
+		std::string result;
+		result.reserve(source.size() + defines.size() * 32);
+		std::istringstream lines(source);
+		std::string line;
+		while (getline(lines, line))
+		{
+			result += line + "\n";
+			size_t start = line.find_first_not_of(" \t");
+			if (start != std::string::npos && line.compare(start, 8, "#version") == 0)
+			{
+				for (const auto& define : defines)
+					result += "#define " + define + "\n";
+			}
+		}
+		return result;
+	}
+
+	bool ShaderPreprocessor::append(const std::string & filePath, std::string & source, std::vector<std::string>& including)
+	{
+		if (including.size() >= maxIncludeDepth || std::find(including.begin(), including.end(), filePath) != including.end())
+		{
+			Log::error("Shader include of {0} nests too deep or includes itself", filePath);
+			return false;
+		}
+
+		std::fstream handle(filePath, std::ios::in);
+		if (!handle.is_open())
+		{
+			Log::error("NOT able to open SHADER source: {0}", filePath);
+			return false;
+		}
+
+		//includes are relative to the file they are in.
+		std::string directory = filePath.substr(0, filePath.find_last_of("/\\") + 1);
+		including.push_back(filePath);
+
+		std::string line;
+		while (getline(handle, line))
+		{
+			size_t start = line.find_first_not_of(" \t");
+			if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+			{
+				source += line + "\n";
+				continue;
+			}
+
+			size_t open = line.find('"', start + 8);
+			size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+			if (close == std::string::npos)
+			{
+				Log::error("Shader include in {0} has no quoted path: {1}", filePath, line);
+				return false;
+			}
+
+			if (!append(directory + line.substr(open + 1, close - open - 1), source, including))
+				return false;
+		}
+
+		including.pop_back();
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,366 @@
+/** \file spriteAtlas.cpp */
+
+#include "engine_pch.h"
+#include "rendering/spriteAtlas.h"
+#include "systems/jobSystem.h"
+#include "systems/log.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "stb_image.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+namespace Engine
+{
+	std::shared_ptr<SpriteAtlas> SpriteAtlas::load(const char * filepath)
+	{
+		std::fstream handle(filepath, std::ios::in);
+		if (!handle.is_open())
+		{
+			Log::error("Could not open sprite atlas: {0}", filepath);
+			return nullptr;
+		}
+
+		//pages sit next to the metadata file.
+		std::string directory(filepath);
+		size_t slash = directory.find_last_of("/\\");
+		directory = (slash == std::string::npos) ? "" : directory.substr(0, slash + 1);
+
+		std::shared_ptr<SpriteAtlas> atlas(new SpriteAtlas);
+		std::string line;
+		while (getline(handle, line))
+		{
+			std::stringstream stream(line);
+			std::string type;
+			stream >> type;
+
+			if (type == "page")
+			{
+				std::string pageFile;
+				stream >> pageFile;
+				atlas->m_pages.push_back(std::shared_ptr<Textures>(Textures::create((directory + pageFile).c_str())));
+			}
+			else if (type == "sprite")
+			{
+				std::string name;
+				uint32_t page;
+				glm::ivec2 position;
+				Sprite sprite;
+				stream >> name >> page >> position.x >> position.y >> sprite.trimSize.x >> sprite.trimSize.y >> sprite.sourceSize.x >> sprite.sourceSize.y >> sprite.trimOffset.x >> sprite.trimOffset.y;
+
+				if (stream.fail() || page >= atlas->m_pages.size())
+				{
+					Log::error("Bad sprite line in atlas {0}: {1}", filepath, line);
+					continue;
+				}
+
+				std::shared_ptr<Textures> texture = atlas->m_pages[page];
+				glm::vec2 pageSize(texture->getWidthF(), texture->getHeightF());
+				sprite.subTexture = SubTexture(texture, glm::vec2(position) / pageSize, glm::vec2(position + sprite.trimSize) / pageSize);
+				atlas->m_sprites[name] = sprite;
+			}
+		}
+
+		return atlas;
+	}
+
+	const Sprite * SpriteAtlas::getSprite(const std::string & name) const
+	{
+		auto it = m_sprites.find(name);
+		return (it == m_sprites.end()) ? nullptr : &it->second;
+	}
+
+	SpriteAtlasBuilder::SpriteAtlasBuilder(const SpriteAtlasSettings & settings) :
+		m_settings(settings)
+	{
+	}
+
+	void SpriteAtlasBuilder::addImage(const std::string & name, const std::string & filepath)
+	{
+		//the name is one field of a space separated line in the .atlas file.
+		if (name.empty() || name.find_first_of(" \t\r\n") != std::string::npos)
+		{
+			Log::error("Sprite names can't be empty or contain whitespace: \"{0}\" ({1})", name, filepath);
+			return;
+		}
+
+		Image image;
+		image.name = name;
+		image.filepath = filepath;
+		m_images.push_back(image);
+	}
+
+	bool SpriteAtlasBuilder::build()
+	{
+		//decoding is the slow part and each image is independent.
+		JobSystem::parallelFor(m_images.size(), [this](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				loadImage(m_images[i], m_settings.trim);
+		});
+
+		//largest first packs tighter.
+		std::vector<uint32_t> order(m_images.size());
+		for (uint32_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+		{
+			const glm::ivec2& sizeA = m_images[a].size;
+			const glm::ivec2& sizeB = m_images[b].size;
+			return std::max(sizeA.x, sizeA.y) > std::max(sizeB.x, sizeB.y);
+		});
+
+		bool success = true;
+		int32_t pageSize = m_settings.pageSize;
+		m_pages.clear();
+
+		for (uint32_t index : order)
+		{
+			Image& image = m_images[index];
+			if (image.pixels.empty())
+			{
+				success = false;
+				continue;
+			}
+
+			int32_t paddedWidth = image.size.x + m_settings.padding;
+			int32_t paddedHeight = image.size.y + m_settings.padding;
+			if (paddedWidth > pageSize || paddedHeight > pageSize)
+			{
+				Log::error("Image too big for a sprite atlas page: {0}", image.filepath);
+				image.pixels.clear();
+				success = false;
+				continue;
+			}
+
+			//try the pages there are, then start a new one.
+			bool placed = false;
+			for (uint32_t i = 0; i < m_pages.size() && !placed; i++)
+			{
+				if (insert(m_pages[i], paddedWidth, paddedHeight, image.position))
+				{
+					image.page = i;
+					placed = true;
+				}
+			}
+
+			if (!placed)
+			{
+				Page page;
+				page.freeRects.push_back({ 0, 0, pageSize, pageSize });
+				insert(page, paddedWidth, paddedHeight, image.position);
+				image.page = m_pages.size();
+				m_pages.push_back(std::move(page));
+			}
+		}
+
+		//copy each image into its page; images don't overlap so they can all go at once.
+		for (auto& page : m_pages)
+			page.pixels.assign(pageSize * pageSize * 4, 0);
+
+		JobSystem::parallelFor(m_images.size(), [this, pageSize](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const Image& image = m_images[i];
+				if (image.pixels.empty())
+					continue;
+
+				unsigned char* pagePixels = m_pages[image.page].pixels.data();
+				for (int32_t row = 0; row < image.size.y; row++)
+					memcpy(pagePixels + ((image.position.y + row) * pageSize + image.position.x) * 4, image.pixels.data() + row * image.size.x * 4, image.size.x * 4);
+			}
+		});
+
+		return success;
+	}
+
+	std::shared_ptr<SpriteAtlas> SpriteAtlasBuilder::upload() const
+	{
+		std::shared_ptr<SpriteAtlas> atlas(new SpriteAtlas);
+		float pageSize = static_cast<float>(m_settings.pageSize);
+
+		for (const auto& page : m_pages)
+			atlas->m_pages.push_back(std::shared_ptr<Textures>(Textures::create(m_settings.pageSize, m_settings.pageSize, 4, const_cast<unsigned char*>(page.pixels.data()))));
+
+		for (const auto& image : m_images)
+		{
+			if (image.pixels.empty())
+				continue;
+
+			Sprite sprite;
+			sprite.subTexture = SubTexture(atlas->m_pages[image.page], glm::vec2(image.position) / pageSize, glm::vec2(image.position + image.size) / pageSize);
+			sprite.sourceSize = image.sourceSize;
+			sprite.trimOffset = image.trimOffset;
+			sprite.trimSize = image.size;
+			atlas->m_sprites[image.name] = sprite;
+		}
+
+		return atlas;
+	}
+
+	bool SpriteAtlasBuilder::write(const std::string & directory, const std::string & name) const
+	{
+		std::fstream handle(directory + "/" + name + ".atlas", std::ios::out);
+		if (!handle.is_open())
+		{
+			Log::error("Could not write sprite atlas: {0}", directory + "/" + name + ".atlas");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < m_pages.size(); i++)
+		{
+			std::string pageFile = name + "_" + std::to_string(i) + ".png";
+			if (!stbi_write_png((directory + "/" + pageFile).c_str(), m_settings.pageSize, m_settings.pageSize, 4, m_pages[i].pixels.data(), m_settings.pageSize * 4))
+			{
+				Log::error("Could not write sprite atlas page: {0}", pageFile);
+				return false;
+			}
+			handle << "page " << pageFile << "\n";
+		}
+
+		//sprite name page x y width height sourceWidth sourceHeight trimX trimY
+		for (const auto& image : m_images)
+		{
+			if (image.pixels.empty())
+				continue;
+
+			handle << "sprite " << image.name << " " << image.page << " " << image.position.x << " " << image.position.y << " "
+				<< image.size.x << " " << image.size.y << " " << image.sourceSize.x << " " << image.sourceSize.y << " "
+				<< image.trimOffset.x << " " << image.trimOffset.y << "\n";
+		}
+
+		return true;
+	}
+
+	void SpriteAtlasBuilder::loadImage(Image & image, bool trim)
+	{
+		//always RGBA so every page is the same format.
+		int width, height, channel;
+		unsigned char* data = stbi_load(image.filepath.c_str(), &width, &height, &channel, 4);
+		if (!data)
+		{
+			Log::error("Could not load image for sprite atlas: {0}", image.filepath);
+			return;
+		}
+
+		image.sourceSize = glm::ivec2(width, height);
+		image.trimOffset = glm::ivec2(0);
+		image.size = image.sourceSize;
+
+		if (trim)
+		{
+			//bounds of everything that isn't fully transparent.
+			glm::ivec2 min(width, height);
+			glm::ivec2 max(-1);
+			for (int32_t y = 0; y < height; y++)
+			{
+				for (int32_t x = 0; x < width; x++)
+				{
+					if (data[(y * width + x) * 4 + 3] != 0)
+					{
+						min = glm::ivec2(std::min(min.x, x), std::min(min.y, y));
+						max = glm::ivec2(std::max(max.x, x), std::max(max.y, y));
+					}
+				}
+			}
+
+			//a fully transparent image is left as it is.
+			if (max.x >= 0)
+			{
+				image.trimOffset = min;
+				image.size = max - min + glm::ivec2(1);
+			}
+		}
+
+		image.pixels.resize(image.size.x * image.size.y * 4);
+		for (int32_t row = 0; row < image.size.y; row++)
+			memcpy(&image.pixels[row * image.size.x * 4], data + ((image.trimOffset.y + row) * width + image.trimOffset.x) * 4, image.size.x * 4);
+
+		stbi_image_free(data);
+	}
+
+	bool SpriteAtlasBuilder::insert(Page & page, int32_t width, int32_t height, glm::ivec2 & position)
+	{
+		//best short side fit; the free rectangle that leaves the smallest gap on its tighter side.
+		const Rect* best = nullptr;
+		int32_t bestShortSide = INT32_MAX;
+		int32_t bestLongSide = INT32_MAX;
+		for (const auto& free : page.freeRects)
+		{
+			if (free.width < width || free.height < height)
+				continue;
+
+			int32_t leftoverX = free.width - width;
+			int32_t leftoverY = free.height - height;
+			int32_t shortSide = std::min(leftoverX, leftoverY);
+			int32_t longSide = std::max(leftoverX, leftoverY);
+			if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+			{
+				best = &free;
+				bestShortSide = shortSide;
+				bestLongSide = longSide;
+			}
+		}
+
+		if (!best)
+			return false;
+
+		Rect placed = { best->x, best->y, width, height };
+		position = glm::ivec2(placed.x, placed.y);
+
+		//split every free rectangle the new one overlaps into the (up to four) maximal rectangles around it.
+		std::vector<Rect> freeRects;
+		for (const auto& free : page.freeRects)
+		{
+			bool overlaps = placed.x < free.x + free.width && placed.x + placed.width > free.x &&
+				placed.y < free.y + free.height && placed.y + placed.height > free.y;
+			if (!overlaps)
+			{
+				freeRects.push_back(free);
+				continue;
+			}
+
+			if (placed.x > free.x)
+				freeRects.push_back({ free.x, free.y, placed.x - free.x, free.height });
+			if (placed.x + placed.width < free.x + free.width)
+				freeRects.push_back({ placed.x + placed.width, free.y, free.x + free.width - (placed.x + placed.width), free.height });
+			if (placed.y > free.y)
+				freeRects.push_back({ free.x, free.y, free.width, placed.y - free.y });
+			if (placed.y + placed.height < free.y + free.height)
+				freeRects.push_back({ free.x, placed.y + placed.height, free.width, free.y + free.height - (placed.y + placed.height) });
+		}
+
+		//drop any free rectangle that sits entirely inside another.
+		auto contains = [](const Rect& outer, const Rect& inner)
+		{
+			return inner.x >= outer.x && inner.y >= outer.y &&
+				inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+		};
+
+		for (int32_t i = 0; i < static_cast<int32_t>(freeRects.size()); i++)
+		{
+			for (int32_t j = i + 1; j < static_cast<int32_t>(freeRects.size());)
+			{
+				if (contains(freeRects[i], freeRects[j]))
+				{
+					freeRects.erase(freeRects.begin() + j);
+					continue;
+				}
+				if (contains(freeRects[j], freeRects[i]))
+				{
+					freeRects.erase(freeRects.begin() + i);
+					i--;
+					break;
+				}
+				j++;
+			}
+		}
+
+		page.freeRects = std::move(freeRects);
+		return true;
+	}
+}
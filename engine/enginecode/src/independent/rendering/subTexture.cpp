@@ -6,15 +6,15 @@
 namespace Engine
 {
 
-	SubTexture::SubTexture(const std::shared_ptr<OpenGLTexture>& texture, const glm::vec2 & UVStart, const glm::vec2 & UVEnd) : 
+	SubTexture::SubTexture(const std::shared_ptr<Textures>& texture, const glm::vec2 & UVStart, const glm::vec2 & UVEnd) : 
 		m_texture(texture),
 		m_UVStart(UVStart),
 		m_UVEnd(UVEnd)
 	{
 		//first calcuate the size of the x & y, minus start from end and then times by size of the texture to get the pixel size.
 		//size is an int so static_casting to an int.
-		m_size.x = static_cast<int>(m_UVEnd.x - m_UVStart.x) * m_texture->getWidthF();
-		m_size.y = static_cast<int>(m_UVEnd.x - m_UVStart.x) * m_texture->getHeightF();
+		m_size.x = static_cast<int>((m_UVEnd.x - m_UVStart.x) * m_texture->getWidthF());
+		m_size.y = static_cast<int>((m_UVEnd.y - m_UVStart.y) * m_texture->getHeightF());
 
 	}
 
@@ -12,10 +12,26 @@ namespace Engine
 		std::fill(m_buffer.begin(), m_buffer.end(), 0xFFFFFFFF);
 	}
 
+	bool TextureUnitManager::isBound(uint32_t textureID)
+	{
+		//when full the head has wrapped round onto the tail, so every unit is in use.
+		uint32_t end = m_capacityFull ? m_capacity : m_head;
+
+		for (uint32_t i = m_tail; i < end; i++)
+		{
+			if (m_buffer.at(i) == textureID)
+				return true;
+		}
+		return false;
+	}
+
 	bool TextureUnitManager::getUnit(uint32_t textureID, uint32_t & textureUnit)
 	{
+		//when full the head has wrapped round onto the tail, so search every unit.
+		uint32_t end = m_capacityFull ? m_capacity : m_head;
+
 		//is texture already bound?
-		for (int i = m_tail; i < m_head; i++)
+		for (uint32_t i = m_tail; i < end; i++)
 		{
 			//check at i in the buffer if that element is equal to texture ID.
 			if (m_buffer.at(i) == textureID)
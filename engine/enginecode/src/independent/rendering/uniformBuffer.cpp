@@ -0,0 +1,52 @@
+/** \file uniformBuffer.cpp */
+#include "engine_pch.h"
+#include "rendering/uniformBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Engine
+{
+	void UniformBuffer::initialiseShadow()
+	{
+		//populate the uniform cache.
+		for (auto& element : m_BufferLayout)
+			m_uniformCache[element.m_name] = { element.m_offset, element.m_size, element.m_dataType };
+		m_shadow.assign(m_BufferLayout.getStride(), 0);
+	}
+
+	void UniformBuffer::uploadDataToBlock(const char * uniformName, const void * data)
+	{
+		auto it = m_uniformCache.find(uniformName);
+		if (it == m_uniformCache.end())
+		{
+			Log::error("Uniform block {0} has no field {1}", m_blockNumber, uniformName);
+			return;
+		}
+		writeField(it->second.offset, it->second.type, data);
+	}
+
+	void UniformBuffer::write(uint32_t offset, const void * data, uint32_t size)
+	{
+		//setting a field to what it already is costs nothing, so things that rarely change don't get uploaded every frame.
+		if (memcmp(m_shadow.data() + offset, data, size) == 0)
+			return;
+		memcpy(m_shadow.data() + offset, data, size);
+		m_dirtyBegin = std::min(m_dirtyBegin, offset);
+		m_dirtyEnd = std::max(m_dirtyEnd, offset + size);
+	}
+
+	void UniformBuffer::writeField(uint32_t offset, ShaderDataType type, const void * data)
+	{
+		//a glm::mat3 is three packed vec3s, but std140 starts each column on 16 bytes.
+		if (type == ShaderDataType::Mat3)
+		{
+			const unsigned char* columns = static_cast<const unsigned char*>(data);
+			for (uint32_t column = 0; column < 3; column++)
+				write(offset + column * 16, columns + column * 12, 12);
+			return;
+		}
+
+		//as many bytes as the value has, which can be less than the room it takes in the block; a vec3 is 12 bytes in a 16 byte slot.
+		write(offset, data, SDT::size(type));
+	}
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "engine_pch.h"
 #include "systems/generalFunctions.h"
+#include <cstring>
 
 namespace Engine
 {
@@ -76,4 +77,24 @@ namespace Engine
 		result = (r | g | b | a);
 		return result;
 	}
+
+	uint64_t GenFuncs::hash(const void * data, size_t size, uint64_t seed)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			seed ^= bytes[i];
+			seed *= 0x100000001B3ull;
+		}
+		return seed;
+	}
+
+	uint64_t GenFuncs::hash(const char * string, uint64_t seed)
+	{
+		if (!string)
+			string = "";
+		size_t length = strlen(string);
+		seed = hash(&length, sizeof(length), seed);
+		return hash(string, length, seed);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+/** \file jobSystem.cpp */
+
+#include "engine_pch.h"
+#include "systems/jobSystem.h"
+#include <algorithm>
+
+namespace Engine
+{
+	//initialising the statics.
+	std::vector<std::thread> JobSystem::s_workers;
+	std::queue<std::packaged_task<void(void)>> JobSystem::s_jobs;
+	std::mutex JobSystem::s_mutex;
+	std::condition_variable JobSystem::s_condition;
+	bool JobSystem::s_running = false;
+
+	void JobSystem::start(SystemSignal init, ...)
+	{
+		s_running = true;
+
+		//hardware_concurrency can report 0 if unknown, so always have at least one worker.
+		uint32_t workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_workers.emplace_back(&JobSystem::workerLoop);
+	}
+
+	void JobSystem::stop(SystemSignal close, ...)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_running = false;
+		}
+		s_condition.notify_all();
+
+		for (auto& worker : s_workers)
+			worker.join();
+		s_workers.clear();
+	}
+
+	std::future<void> JobSystem::submit(const std::function<void(void)>& job)
+	{
+		std::packaged_task<void(void)> task(job);
+		std::future<void> result = task.get_future();
+
+		//no workers, so do it here and now.
+		if (s_workers.empty())
+		{
+			task();
+			return result;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_jobs.push(std::move(task));
+		}
+		s_condition.notify_one();
+
+		return result;
+	}
+
+	void JobSystem::parallelFor(uint32_t count, const std::function<void(uint32_t, uint32_t)>& job)
+	{
+		if (count == 0)
+			return;
+
+		//one range per worker plus one for this thread.
+		uint32_t rangeCount = std::min(count, getWorkerCount() + 1);
+		uint32_t rangeSize = (count + rangeCount - 1) / rangeCount;
+
+		std::vector<std::future<void>> results;
+		for (uint32_t begin = rangeSize; begin < count; begin += rangeSize)
+		{
+			uint32_t end = std::min(begin + rangeSize, count);
+			results.push_back(submit([&job, begin, end]() { job(begin, end); }));
+		}
+
+		//this thread takes the first range rather than sitting idle.
+		job(0, std::min(rangeSize, count));
+
+		for (auto& result : results)
+			result.get();
+	}
+
+	void JobSystem::workerLoop()
+	{
+		while (true)
+		{
+			std::packaged_task<void(void)> task;
+			{
+				std::unique_lock<std::mutex> lock(s_mutex);
+				s_condition.wait(lock, []() { return !s_running || !s_jobs.empty(); });
+
+				//only leave once the queue is empty, so nothing that was submitted is dropped.
+				if (!s_running && s_jobs.empty())
+					return;
+
+				task = std::move(s_jobs.front());
+				s_jobs.pop();
+			}
+			task();
+		}
+	}
+}
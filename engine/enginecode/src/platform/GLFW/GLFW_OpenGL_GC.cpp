@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "platform/GLFW/GLFW_OpenGL_GC.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include "systems/log.h"
 
 namespace Engine
@@ -57,5 +58,6 @@ namespace Engine
 	void GLFW_OpenGL_GC::swapBuffers()
 	{
 		glfwSwapBuffers(m_window);
+		OpenGLStateCache::endFrame();
 	}
 }
\ No newline at end of file
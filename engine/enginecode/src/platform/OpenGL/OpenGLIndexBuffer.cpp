@@ -2,19 +2,26 @@
 
 #include "engine_pch.h"
 #include "platform/OpenGL/OpenGLIndexBuffer.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include <glad/glad.h>
 
 namespace Engine
 {
 	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count) : m_count(count)
 	{
+		//straight to the buffer; binding it as an element array would attach it to whichever VAO happens to be bound.
 		glCreateBuffers(1, &m_OpenGL_ID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_OpenGL_ID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * count, indices, GL_STATIC_DRAW); //if create edit function, need to change to GL_DYNAMIC_DRAW
+		glNamedBufferData(m_OpenGL_ID, sizeof(uint32_t) * count, indices, GL_DYNAMIC_DRAW);
 	}
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
+		OpenGLStateCache::onBufferDeleted(m_OpenGL_ID);
 		glDeleteBuffers(1, &m_OpenGL_ID);
 	}
+
+	void OpenGLIndexBuffer::edit(const uint32_t * indices, uint32_t count, uint32_t offset)
+	{
+		glNamedBufferSubData(m_OpenGL_ID, sizeof(uint32_t) * offset, sizeof(uint32_t) * count, indices);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+/** \file OpenGLProgramCache.cpp */
+
+#include "engine_pch.h"
+#include "platform/OpenGL/OpenGLProgramCache.h"
+#include "systems/log.h"
+#include "systems/generalFunctions.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace Engine
+{
+	std::string OpenGLProgramCache::s_directory = "shaderCache";
+
+	uint64_t OpenGLProgramCache::makeKey(const std::vector<const char*>& sources)
+	{
+		//64 bit FNV-1a; plenty for telling a handful of shaders apart, and the header keeps the full key.
+		//each string's length goes in too, so moving text from one stage to the next changes the key.
+		uint64_t hash = GenFuncs::hash(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+		hash = GenFuncs::hash(reinterpret_cast<const char*>(glGetString(GL_RENDERER)), hash);
+		hash = GenFuncs::hash(reinterpret_cast<const char*>(glGetString(GL_VERSION)), hash);
+		for (const char* source : sources)
+			hash = GenFuncs::hash(source, hash);
+		return hash;
+	}
+
+	bool OpenGLProgramCache::isSupported()
+	{
+		static GLint formats = -1;
+		if (formats < 0)
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		return formats > 0;
+	}
+
+	bool OpenGLProgramCache::load(uint32_t program, uint64_t key)
+	{
+		if (!isSupported())
+			return false;
+
+		std::ifstream file(getPath(key), std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		FileHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != s_magic || header.version != s_version || header.key != key)
+			return false;
+
+		std::vector<char> binary(header.size);
+		if (!file.read(binary.data(), header.size))
+			return false;
+
+		//a driver update can reject a binary even with the same version string; that's a miss, not an error.
+		glProgramBinary(program, header.format, binary.data(), header.size);
+		GLint isLinked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		return isLinked == GL_TRUE;
+	}
+
+	void OpenGLProgramCache::store(uint32_t program, uint64_t key)
+	{
+		if (!isSupported())
+			return;
+
+		GLint size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if (size <= 0)
+			return;
+
+		FileHeader header = { s_magic, s_version, key, 0, 0 };
+		std::vector<char> binary(size);
+		GLsizei written = 0;
+		GLenum format = 0;
+		glGetProgramBinary(program, size, &written, &format, binary.data());
+		header.format = format;
+		header.size = written;
+
+		std::error_code error;
+		std::filesystem::create_directories(s_directory, error);
+
+		std::ofstream file(getPath(key), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			Log::error("NOT able to write shader program binary: {0}", getPath(key));
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), written);
+	}
+
+	std::string OpenGLProgramCache::getPath(uint64_t key)
+	{
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+		return s_directory + "/" + name + ".bin";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/** \file OpenGLRingBuffer.cpp */
+
+#include "engine_pch.h"
+#include "platform/OpenGL/OpenGLRingBuffer.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace Engine
+{
+	OpenGLRingBuffer::OpenGLRingBuffer(uint32_t frameSize, uint32_t frameCount) :
+		m_fences(frameCount, nullptr)
+	{
+		//offsets have to suit both ways the buffer might be bound.
+		GLint uniformAlignment = 256;
+		GLint storageAlignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+		m_alignment = std::max(std::max(uniformAlignment, storageAlignment), 16);
+
+		//sections start aligned too.
+		m_frameSize = (frameSize + m_alignment - 1) / m_alignment * m_alignment;
+
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &m_OpenGL_ID);
+		glNamedBufferStorage(m_OpenGL_ID, m_frameSize * frameCount, nullptr, flags);
+		m_mapped = static_cast<unsigned char*>(glMapNamedBufferRange(m_OpenGL_ID, 0, m_frameSize * frameCount, flags));
+
+		if (!m_mapped)
+			Log::error("Could not map ring buffer of {0} bytes", m_frameSize * frameCount);
+	}
+
+	OpenGLRingBuffer::~OpenGLRingBuffer()
+	{
+		for (auto& fence : m_fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+
+		glUnmapNamedBuffer(m_OpenGL_ID);
+		OpenGLStateCache::onBufferDeleted(m_OpenGL_ID);
+		glDeleteBuffers(1, &m_OpenGL_ID);
+	}
+
+	void OpenGLRingBuffer::beginFrame()
+	{
+		m_frame = (m_frame + 1) % m_fences.size();
+		m_used = 0;
+
+		//the GPU may still be reading what was written here a ring ago.
+		GLsync& fence = m_fences[m_frame];
+		if (fence)
+		{
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+			if (result == GL_WAIT_FAILED)
+				Log::error("Ring buffer fence wait failed");
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	void * OpenGLRingBuffer::allocate(uint32_t size, uint32_t & offset)
+	{
+		uint32_t start = (m_used + m_alignment - 1) / m_alignment * m_alignment;
+		if (!m_mapped || start + size > m_frameSize)
+			return nullptr;
+
+		m_used = start + size;
+		offset = m_frame * m_frameSize + start;
+		return m_mapped + offset;
+	}
+
+	void OpenGLRingBuffer::endFrame()
+	{
+		//everything that reads this section has been issued; a fence left from ending the frame twice is replaced, not leaked.
+		GLsync& fence = m_fences[m_frame];
+		if (fence)
+			glDeleteSync(fence);
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
@@ -1,70 +1,43 @@
 /** \file OpenGLShader.cpp */
 
 #include "engine_pch.h"
-#include <fstream>
+#include <sstream>
 #include <string>
 #include <array>
+#include <algorithm>
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 #include <glad/glad.h>
 #include "platform/OpenGL/OpenGLShader.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "platform/OpenGL/OpenGLProgramCache.h"
+#include "rendering/storageBuffer.h"
+#include "rendering/textures.h"
+#include "rendering/shaderPreprocessor.h"
 #include "systems/log.h"
 
+//the ARB extension shares the value; not every loader has either.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace Engine
 {
-	OpenGLShader::OpenGLShader(const char * vertexFilePath, const char * fragmentFilePath)
+	OpenGLShader::OpenGLShader(const char * vertexFilePath, const char * fragmentFilePath, bool async)
 	{
 		//declarations.
-		std::string line;
 		std::string vertexSource;
 		std::string fragmentSource;
-		
-		//vertex shader file path.
-		std::fstream handle(vertexFilePath, std::ios::in);
-		//check that it has vertex file path.
-		if (handle.is_open())
-		{
-			//opens fine, so need to read it...
-			//whilst open, read it in line by line, adding it to source.
-			while (getline(handle, line))
-			{
-				vertexSource += (line + "\n");
-			}
-		}
-		else
-		{
-			//otherwise throw error and return.
-			Log::error("NOT able to open VERTEX SHADER source: {0}", vertexFilePath);
-			return;
-		}
-		//close the file.
-		handle.close();
 
-		//fragment shader file path.
-		handle.open(fragmentFilePath, std::ios::in);
-		//check that it has fragment filepath
-		if (handle.is_open())
-		{
-			//opens fine, so need to read it...
-			//whilst open, read it in line by line, adding it to source.
-			while (getline(handle, line))
-			{
-				fragmentSource += (line + "\n");
-			}
-		}
-		else
-		{
-			//otherwise throw error and return.
-			Log::error("NOT able to open FRAGMENT SHADER source: {0}", fragmentFilePath);
+		//read each file with its includes; the preprocessor reports which file it couldn't open.
+		if (!ShaderPreprocessor::load(vertexFilePath, vertexSource) || !ShaderPreprocessor::load(fragmentFilePath, fragmentSource))
 			return;
-		}
-		//close the file.
-		handle.close();
 
 		//got source for each, so compile and link them, converting them to c_strings.
-		compileAndLink(vertexSource.c_str(), fragmentSource.c_str());
+		compileAndLink({ { GL_VERTEX_SHADER, "vertex", vertexSource.c_str() }, { GL_FRAGMENT_SHADER, "fragment", fragmentSource.c_str() } }, async);
 	}
 
-	OpenGLShader::OpenGLShader(const char * filePath)
+	OpenGLShader::OpenGLShader(const char * filePath, const std::vector<std::string>& defines, bool async)
 	{
 		//enum Region for different types of shaders.
 		//NOTE - not the best to only declare locally.
@@ -76,182 +49,474 @@ namespace Engine
 		std::array<std::string, Region::Compute + 1> source;		//adding one to Compute (which 5 in the enum) will make an array of 6 elements.
 		uint32_t region = Region::None;		// index for which region we are in, initialised to None(-1).
 
-		std::fstream handle(filePath, std::ios::in);
-		//check that it has the file path.
-		if (handle.is_open())
+		//the whole file with its includes resolved, and this variant's defines after each region's #version.
+		std::string text;
+		if (!ShaderPreprocessor::load(filePath, text))
+			return;
+		std::istringstream handle(ShaderPreprocessor::addDefines(text, defines));
+		//read it line by line, adding each to the region it is in.
+		while (getline(handle, line))
 		{
-			//opens fine, so need to read it...
-			//whilst open, read it in line by line, adding it to source.
-			while (getline(handle, line))
+			//which region are we in? 
+			//continue is to skip of the #vertex /#fragment etc part of the text document.
+			if (line.find("#region Vertex") != std::string::npos) {
+				region = Region::Vertex; continue;
+			}
+			if (line.find("#region Fragment") != std::string::npos) {
+				region = Region::Fragment; continue;
+			}
+			if (line.find("#region Geometry") != std::string::npos) {
+				region = Region::Geometry; continue;
+			}
+			if (line.find("#region TessellationControl") != std::string::npos) {
+				region = Region::TessellationControl; continue;
+			}
+			if (line.find("#region TessellationEvalution") != std::string::npos) {
+				region = Region::TessellationEvalution; continue;
+			}
+			if (line.find("#region Compute") != std::string::npos) {
+				region = Region::Compute; continue;
+			}
+
+			//if region not = none (it has a value), then stick it into region.
+			if(region != Region::None)
 			{
-				//which region are we in? 
-				//continue is to skip of the #vertex /#fragment etc part of the text document.
-				if (line.find("#region Vertex") != std::string::npos) {
-					region = Region::Vertex; continue;
-				}
-				if (line.find("#region Fragment") != std::string::npos) {
-					region = Region::Fragment; continue;
-				}
-				if (line.find("#region Geometry") != std::string::npos) {
-					region = Region::Geometry; continue;
-				}
-				if (line.find("#region TessellationControl") != std::string::npos) {
-					region = Region::TessellationControl; continue;
-				}
-				if (line.find("#region TessellationEvalution") != std::string::npos) {
-					region = Region::TessellationEvalution; continue;
-				}
-				if (line.find("#region Compute") != std::string::npos) {
-					region = Region::Compute; continue;
-				}
-
-				//if region not = none (it has a value), then stick it into region.
-				if(region != Region::None)
-				{
-					source[region] += (line + "\n");
-				}
+				source[region] += (line + "\n");
 			}
 		}
-		else
+
+		//got source, so compile and link every region that has something in it, converting them to c_strings.
+		const std::array<StageSource, Region::Compute + 1> regionStages = { {
+			{ GL_VERTEX_SHADER, "vertex", nullptr },
+			{ GL_FRAGMENT_SHADER, "fragment", nullptr },
+			{ GL_GEOMETRY_SHADER, "geometry", nullptr },
+			{ GL_TESS_CONTROL_SHADER, "tessellation control", nullptr },
+			{ GL_TESS_EVALUATION_SHADER, "tessellation evaluation", nullptr },
+			{ GL_COMPUTE_SHADER, "compute", nullptr }
+		} };
+		std::vector<StageSource> stages;
+		for (uint32_t i = 0; i < regionStages.size(); i++)
 		{
-			//otherwise throw error and return.
-			Log::error("NOT able to open SINGLE FILE source: {0}", filePath);
-			return;
+			if (source[i].find_first_not_of(" \t\r\n") == std::string::npos)
+				continue;
+			stages.push_back(regionStages[i]);
+			stages.back().source = source[i].c_str();
 		}
-		//close the file.
-		handle.close();
 
-		//got source, so compile and link, converting them to c_strings.
-		//TODO: this below will only compile Vertex and Fragment shaders, need expansion to include other shaders.
-		//HOW: pass it an array maybe, integar of flags to say which is present, flag system could work.
-		compileAndLink(source[Region::Vertex].c_str(), source[Region::Fragment].c_str());
+		compileAndLink(stages, async);
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
+		//a link still pending can be abandoned; deleting the program doesn't wait for it.
+		for (const auto& stage : m_stages)
+			glDeleteShader(stage.shader);
+		OpenGLStateCache::onProgramDeleted(m_OpenGL_ID);
 		glDeleteProgram(m_OpenGL_ID);
 	}
 
 	void OpenGLShader::uploadInt(const char * name, int value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform1i(location, value);
+		upload(UniformHandle<int>(getUniformLocation(name, ShaderDataType::Int)), value);
+	}
+
+	void OpenGLShader::uploadIntArray(const char * name, int32_t * values, uint32_t count)
+	{
+		upload(UniformHandle<int>(getUniformLocation(name, ShaderDataType::Int)), values, count);
 	}
 
 	void OpenGLShader::uploadFloat(const char * name, float value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform1f(location, value);
+		upload(UniformHandle<float>(getUniformLocation(name, ShaderDataType::Float)), value);
 	}
 
 	void OpenGLShader::uploadFloat2(const char * name, const glm::vec2 & value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform2f(location, value.x, value.y);
+		upload(UniformHandle<glm::vec2>(getUniformLocation(name, ShaderDataType::Float2)), value);
 	}
 
 	void OpenGLShader::uploadFloat3(const char * name, const glm::vec3 & value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform3f(location, value.x, value.y, value.z);
+		upload(UniformHandle<glm::vec3>(getUniformLocation(name, ShaderDataType::Float3)), value);
 	}
 
 	void OpenGLShader::uploadFloat4(const char * name, const glm::vec4 & value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform4f(location, value.x, value.y, value.z, value.w);
+		upload(UniformHandle<glm::vec4>(getUniformLocation(name, ShaderDataType::Float4)), value);
 	}
 
 	void OpenGLShader::uploadMat4(const char * name, const glm::mat4 & value)
 	{
-		uint32_t location = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+		upload(UniformHandle<glm::mat4>(getUniformLocation(name, ShaderDataType::Mat4)), value);
+	}
+
+	int32_t OpenGLShader::getUniformLocation(const char * name, ShaderDataType type)
+	{
+		//the table isn't there until it has linked; asking early waits for it rather than reporting everything missing.
+		wait();
+		auto it = m_uniforms.find(name);
+		if (it == m_uniforms.end())
+		{
+			reportOnce(name, "is not an active uniform");
+			return -1;
+		}
+
+		if (it->second.type != type)
+		{
+			reportOnce(name, "is a different type to the one uploaded");
+			return -1;
+		}
+
+		return it->second.location;
+	}
+
+	//uploads go straight to the program by name, so nothing needs binding and whatever is bound is left alone.
+	void OpenGLShader::upload(UniformHandle<int> handle, int value)
+	{
+		if (handle.isValid())
+			glProgramUniform1i(m_OpenGL_ID, handle.getLocation(), value);
+	}
+
+	void OpenGLShader::upload(UniformHandle<int> handle, const int32_t * values, uint32_t count)
+	{
+		if (handle.isValid())
+			glProgramUniform1iv(m_OpenGL_ID, handle.getLocation(), count, values);
+	}
+
+	void OpenGLShader::upload(UniformHandle<float> handle, float value)
+	{
+		if (handle.isValid())
+			glProgramUniform1f(m_OpenGL_ID, handle.getLocation(), value);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec2> handle, const glm::vec2 & value)
+	{
+		if (handle.isValid())
+			glProgramUniform2f(m_OpenGL_ID, handle.getLocation(), value.x, value.y);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec3> handle, const glm::vec3 & value)
+	{
+		if (handle.isValid())
+			glProgramUniform3f(m_OpenGL_ID, handle.getLocation(), value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec4> handle, const glm::vec4 & value)
+	{
+		if (handle.isValid())
+			glProgramUniform4f(m_OpenGL_ID, handle.getLocation(), value.x, value.y, value.z, value.w);
+	}
 
+	void OpenGLShader::upload(UniformHandle<glm::mat3> handle, const glm::mat3 & value)
+	{
+		if (handle.isValid())
+			glProgramUniformMatrix3fv(m_OpenGL_ID, handle.getLocation(), 1, GL_FALSE, glm::value_ptr(value));
 	}
 
-	void OpenGLShader::compileAndLink(const char * vertexShaderScr, const char * fragmentShaderScr)
+	void OpenGLShader::upload(UniformHandle<glm::mat4> handle, const glm::mat4 & value)
 	{
-		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		if (handle.isValid())
+			glProgramUniformMatrix4fv(m_OpenGL_ID, handle.getLocation(), 1, GL_FALSE, glm::value_ptr(value));
+	}
 
-		//get the source and compile it.
-		const GLchar* source = vertexShaderScr;
-		glShaderSource(vertexShader, 1, &source, 0);
-		glCompileShader(vertexShader);
+	void OpenGLShader::bindStorageBuffer(uint32_t binding, const std::shared_ptr<StorageBuffer>& buffer)
+	{
+		OpenGLStateCache::bindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, buffer->getID(), 0, buffer->getSize());
+	}
 
-		GLint isCompiled = 0;
-		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &isCompiled);
-		//check it has compiled, error message if not and delete it.
-		if (isCompiled == GL_FALSE)
+	void OpenGLShader::bindImage(uint32_t unit, const std::shared_ptr<Textures>& texture, ImageAccess access)
+	{
+		//the engine's textures are 8 bits a channel; 3 channels has no image format to match.
+		GLenum format;
+		switch (texture->getChannel())
 		{
-			GLint maxLength = 0;
-			glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &maxLength);
+		case 1:		format = GL_R8;		break;
+		case 4:		format = GL_RGBA8;	break;
+		default:
+			Log::error("Shader {0}: a {1} channel texture can't be bound as an image", m_OpenGL_ID, texture->getChannel());
+			return;
+		}
 
-			std::vector<GLchar> infoLog(maxLength);
-			glGetShaderInfoLog(vertexShader, maxLength, &maxLength, &infoLog[0]);
-			Log::error("Shader compile error: {0}", std::string(infoLog.begin(), infoLog.end()));
+		GLenum glAccess = access == ImageAccess::Read ? GL_READ_ONLY : (access == ImageAccess::Write ? GL_WRITE_ONLY : GL_READ_WRITE);
+		glBindImageTexture(unit, texture->getID(), 0, GL_FALSE, 0, glAccess, format);
+	}
 
-			//deleting it here if it has failed to compile.
-			glDeleteShader(vertexShader);
+	void OpenGLShader::dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ, uint32_t barriers)
+	{
+		if (!m_isCompute)
+		{
+			reportOnce("dispatch", "can't be done, it isn't a compute shader");
 			return;
 		}
 
-		//fragment shader stuff...
-		//create the fragment shader.
-		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		//a compute shader is usually needed for what comes next, so this waits for it rather than skipping.
+		wait();
+		if (m_status != ShaderStatus::Ready)
+			return;
+
+		OpenGLStateCache::useProgram(m_OpenGL_ID);
+		glDispatchCompute(groupsX, groupsY, groupsZ);
+
+		//the writes aren't visible to whatever reads them next until the matching barrier.
+		GLbitfield glBarriers = 0;
+		if (barriers & ComputeBarrier::storage) glBarriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+		if (barriers & ComputeBarrier::image) glBarriers |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+		if (barriers & ComputeBarrier::texture) glBarriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+		if (barriers & ComputeBarrier::vertex) glBarriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+		if (barriers & ComputeBarrier::command) glBarriers |= GL_COMMAND_BARRIER_BIT;
+		if (glBarriers)
+			glMemoryBarrier(glBarriers);
+	}
+
+	glm::uvec3 OpenGLShader::getWorkGroupSize()
+	{
+		wait();
+		if (!m_isCompute || m_status != ShaderStatus::Ready)
+			return glm::uvec3(0, 0, 0);
+
+		GLint size[3];
+		glGetProgramiv(m_OpenGL_ID, GL_COMPUTE_WORK_GROUP_SIZE, size);
+		return glm::uvec3(size[0], size[1], size[2]);
+	}
+
+	int32_t OpenGLShader::getUniformBlockIndex(const char * name)
+	{
+		wait();
+		auto it = m_uniformBlocks.find(name);
+		if (it == m_uniformBlocks.end())
+		{
+			reportOnce(name, "is not an active uniform block");
+			return -1;
+		}
+
+		return it->second.index;
+	}
+
+	void OpenGLShader::reflect()
+	{
+		m_uniforms.clear();
+		m_uniformBlocks.clear();
+
+		GLint count = 0;
+		GLint maxNameLength = 0;
+		glGetProgramInterfaceiv(m_OpenGL_ID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+		glGetProgramInterfaceiv(m_OpenGL_ID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+		std::vector<GLchar> name(std::max(maxNameLength, 1));
+
+		const GLenum uniformProperties[] = { GL_BLOCK_INDEX, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE };
+		for (GLint i = 0; i < count; i++)
+		{
+			GLint values[4];
+			glGetProgramResourceiv(m_OpenGL_ID, GL_UNIFORM, i, 4, uniformProperties, 4, nullptr, values);
+
+			//block members have no location, they're set through the block's buffer.
+			if (values[0] != -1)
+				continue;
+
+			glGetProgramResourceName(m_OpenGL_ID, GL_UNIFORM, i, name.size(), nullptr, name.data());
+			std::string uniformName(name.data());
+
+			//arrays are reported as name[0], but looked up by name.
+			size_t bracket = uniformName.find('[');
+			if (bracket != std::string::npos)
+				uniformName.resize(bracket);
+
+			ShaderDataType type;
+			switch (values[1])
+			{
+			case GL_FLOAT:			type = ShaderDataType::Float;	break;
+			case GL_FLOAT_VEC2:		type = ShaderDataType::Float2;	break;
+			case GL_FLOAT_VEC3:		type = ShaderDataType::Float3;	break;
+			case GL_FLOAT_VEC4:		type = ShaderDataType::Float4;	break;
+			case GL_FLOAT_MAT3:		type = ShaderDataType::Mat3;	break;
+			case GL_FLOAT_MAT4:		type = ShaderDataType::Mat4;	break;
+			case GL_INT:
+			case GL_BOOL:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_ARRAY:	type = ShaderDataType::Int;	break;
+			default:				type = ShaderDataType::None;	break;
+			}
+
+			m_uniforms[uniformName] = { values[2], type, values[3] };
+		}
 
-		//give it the source and compile it.
-		source = fragmentShaderScr;
-		glShaderSource(fragmentShader, 1, &source, 0);
-		glCompileShader(fragmentShader);
+		glGetProgramInterfaceiv(m_OpenGL_ID, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &count);
+		glGetProgramInterfaceiv(m_OpenGL_ID, GL_UNIFORM_BLOCK, GL_MAX_NAME_LENGTH, &maxNameLength);
+		name.resize(std::max(maxNameLength, 1));
 
-		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &isCompiled);
-		//check that it has been compiled, delete this AND vertex shader if failed to so.
-		if (isCompiled == GL_FALSE)
+		const GLenum blockProperties[] = { GL_BUFFER_DATA_SIZE };
+		for (GLint i = 0; i < count; i++)
 		{
-			GLint maxLength = 0;
-			glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &maxLength);
+			GLint dataSize = 0;
+			glGetProgramResourceiv(m_OpenGL_ID, GL_UNIFORM_BLOCK, i, 1, blockProperties, 1, nullptr, &dataSize);
+			glGetProgramResourceName(m_OpenGL_ID, GL_UNIFORM_BLOCK, i, name.size(), nullptr, name.data());
+			m_uniformBlocks[name.data()] = { i, dataSize };
+		}
+	}
 
-			std::vector<GLchar> infoLog(maxLength);
-			glGetShaderInfoLog(fragmentShader, maxLength, &maxLength, &infoLog[0]);
-			Log::error("Shader compile error: {0}", std::string(infoLog.begin(), infoLog.end()));
+	void OpenGLShader::reportOnce(const std::string & name, const char * problem)
+	{
+		//unused uniforms are optimised out by the driver, so this can just mean the shader doesn't use it.
+		if (m_reported.insert(name).second)
+			Log::error("Shader {0}: {1} {2}", m_OpenGL_ID, name, problem);
+	}
+
+	void OpenGLShader::compileAndLink(const std::vector<StageSource>& stages, bool async)
+	{
+		submit(stages);
 
-			//deleting the fragment AND vertex shaders if it has failed to compile.
-			glDeleteShader(fragmentShader);
-			glDeleteShader(vertexShader);
+		//an async shader is left for getStatus to finish once the driver is done with it.
+		if (!async)
+			wait();
+	}
 
+	void OpenGLShader::submit(const std::vector<StageSource>& stages)
+	{
+		//a compute shader can't be linked with anything else, and a program needs something in it.
+		m_isCompute = std::any_of(stages.begin(), stages.end(), [](const StageSource& stage) { return stage.type == GL_COMPUTE_SHADER; });
+		if (stages.empty() || (m_isCompute && stages.size() > 1))
+		{
+			Log::error("Shader linking error: {0}", stages.empty() ? "no stages to compile" : "a compute stage can't be linked with other stages");
+			m_status = ShaderStatus::Failed;
 			return;
 		}
 
-		//got to link them up with the program.
-		//all compile fined, so create the final shader program.
+		//a program built from the same sources on the same driver before is loaded whole, skipping compiling and linking.
+		//each stage's name goes in with its source, so the same text in a different stage is a different program.
+		std::vector<const char*> keySources;
+		for (const auto& stage : stages)
+		{
+			keySources.push_back(stage.name);
+			keySources.push_back(stage.source);
+		}
+		m_cacheKey = OpenGLProgramCache::makeKey(keySources);
 		m_OpenGL_ID = glCreateProgram();
-		//attach the vertex and fragment shaders and link them.
-		glAttachShader(m_OpenGL_ID, vertexShader);
-		glAttachShader(m_OpenGL_ID, fragmentShader);
+		if (OpenGLProgramCache::load(m_OpenGL_ID, m_cacheKey))
+		{
+			m_status = ShaderStatus::Ready;
+			reflect();
+			return;
+		}
+
+		//every stage is compiled and the program linked without asking how it went; any status query would wait for the driver.
+		for (const auto& stage : stages)
+		{
+			GLuint shader = glCreateShader(stage.type);
+			const GLchar* source = stage.source;
+			glShaderSource(shader, 1, &source, 0);
+			glCompileShader(shader);
+			glAttachShader(m_OpenGL_ID, shader);
+			m_stages.push_back({ shader, stage.name });
+		}
+
+		//asking for a binary that can be cached.
+		glProgramParameteri(m_OpenGL_ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_OpenGL_ID);
+		m_status = ShaderStatus::Compiling;
+	}
 
-		GLint isLinked = 0;
-		glGetProgramiv(m_OpenGL_ID, GL_LINK_STATUS, (int*)&isLinked);
+	void OpenGLShader::finish()
+	{
+		//check each stage compiled, error message if not.
+		bool failed = false;
+		for (const auto& stage : m_stages)
+		{
+			GLint isCompiled = 0;
+			glGetShaderiv(stage.shader, GL_COMPILE_STATUS, &isCompiled);
+			if (isCompiled == GL_FALSE)
+			{
+				GLint maxLength = 0;
+				glGetShaderiv(stage.shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+				std::vector<GLchar> infoLog(std::max(maxLength, 1));
+				glGetShaderInfoLog(stage.shader, maxLength, &maxLength, &infoLog[0]);
+				Log::error("Shader compile error in {0} stage: {1}", stage.name, std::string(infoLog.begin(), infoLog.end()));
+				failed = true;
+			}
+		}
 
-		//check whether they have linked, if not delete all three shaders.
-		if (isLinked == GL_FALSE)
+		//a stage that didn't compile fails the link anyway, its log would only repeat the compile error.
+		if (!failed)
 		{
-			GLint maxLength = 0;
-			glGetProgramiv(m_OpenGL_ID, GL_INFO_LOG_LENGTH, &maxLength);
+			GLint isLinked = 0;
+			glGetProgramiv(m_OpenGL_ID, GL_LINK_STATUS, (int*)&isLinked);
+			if (isLinked == GL_FALSE)
+			{
+				GLint maxLength = 0;
+				glGetProgramiv(m_OpenGL_ID, GL_INFO_LOG_LENGTH, &maxLength);
 
-			std::vector<GLchar> infoLog(maxLength);
-			glGetProgramInfoLog(m_OpenGL_ID, maxLength, &maxLength, &infoLog[0]);
-			Log::error("Shader linking error: {0}", std::string(infoLog.begin(), infoLog.end()));
+				std::vector<GLchar> infoLog(std::max(maxLength, 1));
+				glGetProgramInfoLog(m_OpenGL_ID, maxLength, &maxLength, &infoLog[0]);
+				Log::error("Shader linking error: {0}", std::string(infoLog.begin(), infoLog.end()));
+				failed = true;
+			}
+		}
 
-			glDeleteProgram(m_OpenGL_ID);
-			glDeleteShader(vertexShader);
-			glDeleteShader(fragmentShader);
+		//linked or not, done with the stages, just need the final FCprogram.
+		for (const auto& stage : m_stages)
+		{
+			glDetachShader(m_OpenGL_ID, stage.shader);
+			glDeleteShader(stage.shader);
+		}
+		m_stages.clear();
 
+		if (failed)
+		{
+			glDeleteProgram(m_OpenGL_ID);
+			m_OpenGL_ID = 0;
+			m_status = ShaderStatus::Failed;
 			return;
 		}
 
-		//now linked, can deattach shaders as done with them, just need the final FCprogram.
-		glDetachShader(m_OpenGL_ID, vertexShader);
-		glDetachShader(m_OpenGL_ID, fragmentShader);
+		//next run loads this instead.
+		OpenGLProgramCache::store(m_OpenGL_ID, m_cacheKey);
+
+		//look every uniform up now, so nothing has to ask GL by name later.
+		reflect();
+		m_status = ShaderStatus::Ready;
+	}
+
+	ShaderStatus OpenGLShader::getStatus()
+	{
+		if (m_status == ShaderStatus::Compiling)
+		{
+			//without the extension there is no asking without waiting, so it is finished the first time anyone asks.
+			if (hasParallelCompile())
+			{
+				GLint isComplete = GL_FALSE;
+				glGetProgramiv(m_OpenGL_ID, GL_COMPLETION_STATUS_KHR, &isComplete);
+				if (isComplete == GL_FALSE)
+					return m_status;
+			}
+			finish();
+		}
+		return m_status;
+	}
+
+	void OpenGLShader::wait()
+	{
+		if (m_status == ShaderStatus::Compiling)
+			finish();
+	}
+
+	bool OpenGLShader::hasParallelCompile()
+	{
+		//the driver picks how many threads to compile on; nothing here needs to change that.
+		static bool supported = hasExtension("GL_KHR_parallel_shader_compile") || hasExtension("GL_ARB_parallel_shader_compile");
+		return supported;
+	}
+
+	bool OpenGLShader::hasExtension(const char * name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; i++)
+		{
+			if (strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)), name) == 0)
+				return true;
+		}
+		return false;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+/** \file OpenGLStateCache.cpp */
+
+#include "engine_pch.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include <glad/glad.h>
+
+namespace Engine
+{
+	//initialising the statics; nothing is known until it is set through the cache.
+	uint32_t OpenGLStateCache::s_program = OpenGLStateCache::s_unknown;
+	std::array<uint32_t, OpenGLStateCache::maxTextureUnits> OpenGLStateCache::s_textures = [] { std::array<uint32_t, maxTextureUnits> units; units.fill(s_unknown); return units; }();
+	uint32_t OpenGLStateCache::s_VAO = OpenGLStateCache::s_unknown;
+	std::vector<OpenGLStateCache::BufferBinding> OpenGLStateCache::s_buffers;
+	std::vector<OpenGLStateCache::Capability> OpenGLStateCache::s_capabilities;
+	std::array<uint32_t, 2> OpenGLStateCache::s_blendFunc = { OpenGLStateCache::s_unknown, OpenGLStateCache::s_unknown };
+	std::array<float, 4> OpenGLStateCache::s_clearColour = { 0.f, 0.f, 0.f, 0.f };
+	bool OpenGLStateCache::s_clearColourKnown = false;
+	OpenGLStateStats OpenGLStateCache::s_stats;
+	OpenGLStateStats OpenGLStateCache::s_frameStats;
+
+	bool OpenGLStateCache::record(bool redundant)
+	{
+		if (redundant)
+			s_stats.skipped++;
+		else
+			s_stats.issued++;
+		return !redundant;
+	}
+
+	void OpenGLStateCache::useProgram(uint32_t program)
+	{
+		if (record(s_program == program))
+		{
+			glUseProgram(program);
+			s_program = program;
+		}
+	}
+
+	void OpenGLStateCache::bindTextureUnit(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= maxTextureUnits)
+		{
+			record(false);
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+
+		if (record(s_textures[unit] == texture))
+		{
+			glBindTextureUnit(unit, texture);
+			s_textures[unit] = texture;
+		}
+	}
+
+	void OpenGLStateCache::bindTexture2D(uint32_t texture)
+	{
+		if (record(s_textures[0] == texture))
+		{
+			glBindTexture(GL_TEXTURE_2D, texture);
+			s_textures[0] = texture;
+		}
+	}
+
+	void OpenGLStateCache::bindVertexArray(uint32_t VAO)
+	{
+		if (record(s_VAO == VAO))
+		{
+			glBindVertexArray(VAO);
+			s_VAO = VAO;
+		}
+	}
+
+	void OpenGLStateCache::bindBuffer(uint32_t target, uint32_t buffer)
+	{
+		//belongs to whichever VAO is bound, so the shadow would be wrong as soon as the VAO changed.
+		if (target == GL_ELEMENT_ARRAY_BUFFER)
+		{
+			record(false);
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		for (auto& binding : s_buffers)
+		{
+			if (binding.target == target)
+			{
+				if (record(binding.buffer == buffer))
+				{
+					glBindBuffer(target, buffer);
+					binding.buffer = buffer;
+				}
+				return;
+			}
+		}
+
+		record(false);
+		glBindBuffer(target, buffer);
+		s_buffers.push_back({ target, buffer });
+	}
+
+	void OpenGLStateCache::bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, uint32_t offset, uint32_t size)
+	{
+		record(false);
+		glBindBufferRange(target, index, buffer, offset, size);
+
+		for (auto& binding : s_buffers)
+		{
+			if (binding.target == target)
+			{
+				binding.buffer = buffer;
+				return;
+			}
+		}
+		s_buffers.push_back({ target, buffer });
+	}
+
+	void OpenGLStateCache::setEnabled(uint32_t capability, bool enabled)
+	{
+		for (auto& known : s_capabilities)
+		{
+			if (known.capability == capability)
+			{
+				if (record(known.enabled == enabled))
+				{
+					enabled ? glEnable(capability) : glDisable(capability);
+					known.enabled = enabled;
+				}
+				return;
+			}
+		}
+
+		record(false);
+		enabled ? glEnable(capability) : glDisable(capability);
+		s_capabilities.push_back({ capability, enabled });
+	}
+
+	void OpenGLStateCache::blendFunc(uint32_t source, uint32_t destination)
+	{
+		if (record(s_blendFunc[0] == source && s_blendFunc[1] == destination))
+		{
+			glBlendFunc(source, destination);
+			s_blendFunc = { source, destination };
+		}
+	}
+
+	void OpenGLStateCache::clearColour(float r, float g, float b, float a)
+	{
+		if (record(s_clearColourKnown && s_clearColour == std::array<float, 4>{ r, g, b, a }))
+		{
+			glClearColor(r, g, b, a);
+			s_clearColour = { r, g, b, a };
+			s_clearColourKnown = true;
+		}
+	}
+
+	void OpenGLStateCache::onProgramDeleted(uint32_t program)
+	{
+		//deleting the bound program leaves it in use until something else is, but its name can come back from the next glCreateProgram.
+		if (s_program == program)
+			s_program = s_unknown;
+	}
+
+	void OpenGLStateCache::onTextureDeleted(uint32_t texture)
+	{
+		//GL unbinds a deleted texture from every unit.
+		for (auto& unit : s_textures)
+		{
+			if (unit == texture)
+				unit = 0;
+		}
+	}
+
+	void OpenGLStateCache::onVertexArrayDeleted(uint32_t VAO)
+	{
+		if (s_VAO == VAO)
+			s_VAO = 0;
+	}
+
+	void OpenGLStateCache::onBufferDeleted(uint32_t buffer)
+	{
+		for (auto& binding : s_buffers)
+		{
+			if (binding.buffer == buffer)
+				binding.buffer = 0;
+		}
+	}
+
+	void OpenGLStateCache::invalidate()
+	{
+		s_program = s_unknown;
+		s_textures.fill(s_unknown);
+		s_VAO = s_unknown;
+		s_buffers.clear();
+		s_capabilities.clear();
+		s_blendFunc = { s_unknown, s_unknown };
+		s_clearColourKnown = false;
+	}
+
+	void OpenGLStateCache::endFrame()
+	{
+		s_frameStats = s_stats;
+		s_stats = OpenGLStateStats();
+	}
+}
@@ -0,0 +1,26 @@
+/** \file OpenGLStorageBuffer.cpp */
+
+#include "engine_pch.h"
+#include "platform/OpenGL/OpenGLStorageBuffer.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include <glad/glad.h>
+
+namespace Engine
+{
+	OpenGLStorageBuffer::OpenGLStorageBuffer(const void* data, uint32_t size) : m_size(size)
+	{
+		glCreateBuffers(1, &m_OpenGL_ID);
+		glNamedBufferData(m_OpenGL_ID, size, data, GL_DYNAMIC_DRAW);
+	}
+
+	OpenGLStorageBuffer::~OpenGLStorageBuffer()
+	{
+		OpenGLStateCache::onBufferDeleted(m_OpenGL_ID);
+		glDeleteBuffers(1, &m_OpenGL_ID);
+	}
+
+	void OpenGLStorageBuffer::edit(const void * data, uint32_t size, uint32_t offset)
+	{
+		glNamedBufferSubData(m_OpenGL_ID, offset, size, data);
+	}
+}
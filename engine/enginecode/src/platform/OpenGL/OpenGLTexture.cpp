@@ -2,6 +2,7 @@
 
 #include "engine_pch.h"
 #include "platform/OpenGL/OpenGLTexture.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include <glad/glad.h>
 #include "systems/log.h"
 
@@ -28,14 +29,13 @@ namespace Engine
 
 	OpenGLTexture::~OpenGLTexture()
 	{
+		OpenGLStateCache::onTextureDeleted(m_OpenGL_ID);
 		glDeleteTextures(1, &m_OpenGL_ID);
 	}
 
 	void OpenGLTexture::edit(uint32_t xOffset, uint32_t yOffset, uint32_t width, uint32_t height, unsigned char * data)
 	{
-		//first bind the texture.
-		glBindTexture(GL_TEXTURE_2D, m_OpenGL_ID);
-
+		//no bind needed, glTextureSubImage2D works straight on the handle; binding here would clobber whatever the renderers have on the active unit.
 		//check whether there is any data.
 		if (data)
 		{
@@ -47,6 +47,13 @@ namespace Engine
 			{
 				glTextureSubImage2D(m_OpenGL_ID, 0, xOffset, yOffset, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
 			}
+			else if (m_channel == 1)
+			{
+				//single byte rows aren't 4 byte aligned, so drop the unpack alignment for this upload.
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+				glTextureSubImage2D(m_OpenGL_ID, 0, xOffset, yOffset, width, height, GL_RED, GL_UNSIGNED_BYTE, data);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			}
 		}
 	}
 
@@ -54,7 +61,7 @@ namespace Engine
 	{
 		//generate and bind the texture.
 		glGenTextures(1, &m_OpenGL_ID);
-		glBindTexture(GL_TEXTURE_2D, m_OpenGL_ID);
+		OpenGLStateCache::bindTexture2D(m_OpenGL_ID);
 
 		//tell it how to wrap, here is clamp to the edge.
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -64,10 +71,17 @@ namespace Engine
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		//TO DO!!!
-		//NEED: a channel == 1, especially for dealing with monochromatic bitmaps.
+		if (channel == 1)
+		{
+			//monochromatic bitmaps (glyphs); sampled as white with the single channel as alpha, so they tint like any RGBA texture.
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-		if (channel == 3)
+			GLint swizzle[4] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+		else if (channel == 3)
 		{
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
 		}
@@ -1,6 +1,8 @@
 /** \file OpenGLUniformBuffer.cpp */
 #include "engine_pch.h"
 #include "platform/OpenGL/OpenGLUniformBuffer.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
+#include "platform/OpenGL/OpenGLShader.h"
 #include <glad/glad.h>
 
 namespace Engine
@@ -17,34 +19,39 @@ namespace Engine
 
 		//generate, bind and set UBO.
 		glGenBuffers(1, &m_OpenGL_ID);														//generate Buffer for UBO. 
-		glBindBuffer(GL_UNIFORM_BUFFER, m_OpenGL_ID);										//bind buffer for UBO.
-		glBufferData(GL_UNIFORM_BUFFER, layout.getStride(), nullptr, GL_DYNAMIC_DRAW);		//send data and size.
+		OpenGLStateCache::bindBuffer(GL_UNIFORM_BUFFER, m_OpenGL_ID);									//bind buffer for UBO.
+		std::vector<unsigned char> zeroes(layout.getStride(), 0);
+		glBufferData(GL_UNIFORM_BUFFER, layout.getStride(), zeroes.data(), GL_DYNAMIC_DRAW);		//send data and size.
 		glBindBufferRange(GL_UNIFORM_BUFFER, m_blockNumber, m_OpenGL_ID, 0, layout.getStride());	//bind the range; to UNI_BUFFER, this block, this ubo, from 0 to data siz (ie all of it).
 
-		//populate the uniform cache.
-		for (auto& element : m_BufferLayout)
-		{
-			m_uniformCache[element.m_name] = std::pair<uint32_t, uint32_t>(element.m_offset, element.m_size);
-		}
+		//populate the uniform cache and the CPU copy, which starts out matching the zeroed buffer.
+		initialiseShadow();
 	}
 
 	OpenGLUniformBuffer::~OpenGLUniformBuffer()
 	{
+		OpenGLStateCache::onBufferDeleted(m_OpenGL_ID);
 		glDeleteBuffers(1, &m_OpenGL_ID);
 	}
 
 	void OpenGLUniformBuffer::attachShaderBlock(const std::shared_ptr<Shaders>& shader, const char * blockName)
 	{
-		//now attach to shader.
-		uint32_t blockIndex = glGetUniformBlockIndex(shader->getID(), blockName);		//first get the block number off the shader.
+		//now attach to shader; the block index comes from the table reflected when it was linked.
+		int32_t blockIndex = std::static_pointer_cast<OpenGLShader>(shader)->getUniformBlockIndex(blockName);
+		if (blockIndex < 0)
+			return;
 		glUniformBlockBinding(shader->getID(), blockIndex, m_blockNumber);				//link to binding point.
 
 	}
 
-	void OpenGLUniformBuffer::uploadDataToBlock(const char * uniformName, void * data)
+	void OpenGLUniformBuffer::upload()
 	{
-		//TO DO - a test to make sure that it contains something.
-		auto& pair = m_uniformCache[uniformName];
-		glBufferSubData(GL_UNIFORM_BUFFER, pair.first, pair.second, data);
+		if (m_dirtyEnd <= m_dirtyBegin)
+			return;
+
+		//named, so nothing has to be bound to send it.
+		glNamedBufferSubData(m_OpenGL_ID, m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, m_shadow.data() + m_dirtyBegin);
+		m_dirtyBegin = 0xFFFFFFFF;
+		m_dirtyEnd = 0;
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "engine_pch.h"
 #include "glad/glad.h"
 #include "platform/OpenGL/OpenGLVertexArray.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 
 namespace Engine
 {
@@ -33,23 +34,23 @@ namespace Engine
 	OpenGLVertexArray::OpenGLVertexArray()
 	{
 		glCreateVertexArrays(1, &m_OpenGL_ID);
-		glBindVertexArray(m_OpenGL_ID);
+		OpenGLStateCache::bindVertexArray(m_OpenGL_ID);
 	}
 
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
+		OpenGLStateCache::onVertexArrayDeleted(m_OpenGL_ID);
 		glDeleteVertexArrays(1, &m_OpenGL_ID);
 	}
 
-	//TO DO - need to consider Mat3 and Mat4s as they are different; they cannot be passed directly as a vertice attribute.
 	void OpenGLVertexArray::addVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
 	{
 		m_vertexBuffer.push_back(vertexBuffer);
 
 		//need to bind first.
-		glBindVertexArray(m_OpenGL_ID);
+		OpenGLStateCache::bindVertexArray(m_OpenGL_ID);
 		//then bind the buffer.
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getID());
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getID());
 
 		//get layout and then iterate over it.
 		const auto& layout = vertexBuffer->getLayout();
@@ -61,18 +62,49 @@ namespace Engine
 				normalised = GL_TRUE;
 			}
 
-			//FUTURE - if loading mat4s will need changing.
-			//OK for now
-			glEnableVertexAttribArray(m_verArrAttributeIndex);
-			glVertexAttribPointer(
-				m_verArrAttributeIndex,	
-				SDT::componentCount(element.m_dataType),	
-				SDT::toGLType(element.m_dataType),		
-				normalised,				
-				layout.getStride(),		
-				(void*) element.m_offset
-			);
-			m_verArrAttributeIndex++;
+			//an attribute is at most 4 components, so matrices go in one column per location; a mat4 takes 4 in a row.
+			uint32_t columns = 1;
+			uint32_t components = SDT::componentCount(element.m_dataType);
+			if (element.m_dataType == ShaderDataType::Mat3 || element.m_dataType == ShaderDataType::Mat4)
+			{
+				columns = (element.m_dataType == ShaderDataType::Mat3) ? 3 : 4;
+				components = columns;
+			}
+
+			for (uint32_t column = 0; column < columns; column++)
+			{
+				uint32_t offset = element.m_offset + column * components * sizeof(float);
+				glEnableVertexAttribArray(m_verArrAttributeIndex);
+
+				//ints must stay as ints in the shader (texture units etc), so they need the I version of the pointer.
+				if (element.m_dataType == ShaderDataType::Int)
+				{
+					glVertexAttribIPointer(
+						m_verArrAttributeIndex,
+						components,
+						SDT::toGLType(element.m_dataType),
+						layout.getStride(),
+						(void*) offset
+					);
+				}
+				else
+				{
+					glVertexAttribPointer(
+						m_verArrAttributeIndex,	
+						components,	
+						SDT::toGLType(element.m_dataType),		
+						normalised,				
+						layout.getStride(),		
+						(void*) offset
+					);
+				}
+
+				//per instance buffers step on every n instances rather than every vertex.
+				if (layout.getDivisor() != 0)
+					glVertexAttribDivisor(m_verArrAttributeIndex, layout.getDivisor());
+
+				m_verArrAttributeIndex++;
+			}
 		}
 
 	}
@@ -80,6 +112,9 @@ namespace Engine
 	void OpenGLVertexArray::setIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer)
 	{
 		m_indexBuffer = indexBuffer;
+
+		//attach to the VAO itself, so binding the VAO is all that's needed before a draw.
+		glVertexArrayElementBuffer(m_OpenGL_ID, indexBuffer->getID());
 	}
 
 	uint32_t OpenGLVertexArray::getDrawCount()
@@ -2,6 +2,7 @@
 
 #include "engine_pch.h"
 #include "platform/OpenGL/OpenGLVertexBuffer.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include <glad/glad.h>
 
 namespace Engine
@@ -9,18 +10,27 @@ namespace Engine
 	OpenGLVertexBuffer::OpenGLVertexBuffer(void * vertices, uint32_t size, VertexBufferLayout layout) : m_layout(layout)
 	{
 		glCreateBuffers(1, &m_OpenGL_ID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
 		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_DYNAMIC_DRAW);
+
+		//scanned once here so culling never has to read the vertices back.
+		if (m_layout.getStride() > 0)
+			m_bounds = AABB::fromVertices(vertices, size / m_layout.getStride(), m_layout);
 	}
 
 	OpenGLVertexBuffer::~OpenGLVertexBuffer()
 	{
+		OpenGLStateCache::onBufferDeleted(m_OpenGL_ID);
 		glDeleteBuffers(1, &m_OpenGL_ID);
 	}
 
 	void OpenGLVertexBuffer::edit(void * vertices, uint32_t size, uint32_t offset)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
 		glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+
+		//bounds only grow; overwritten positions may have been further out.
+		if (m_layout.getStride() > 0)
+			m_bounds.grow(AABB::fromVertices(vertices, size / m_layout.getStride(), m_layout));
 	}
 }
\ No newline at end of file
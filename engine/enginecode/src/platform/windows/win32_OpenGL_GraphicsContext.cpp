@@ -2,6 +2,7 @@
 
 #include "engine_pch.h"
 #include "platform/windows/win32_OpenGL_GraphicsContext.h"
+#include "platform/OpenGL/OpenGLStateCache.h"
 #include "systems/log.h"
 #include <glad/glad.h>
 
@@ -77,5 +78,6 @@ namespace Engine
 	void Win32_OpenGL_GraphicsContxt::swapBuffers()
 	{
 		SwapBuffers(m_deviceContext);
+		OpenGLStateCache::endFrame();
 	}
 }
\ No newline at end of file
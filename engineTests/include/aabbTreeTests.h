@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "renderer/aabbTree.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
\ No newline at end of file
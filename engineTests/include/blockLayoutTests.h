@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "rendering/blockLayout.h"
+#include "rendering/bufferLayout.h"
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "renderer/frustum.h"
+#include <glm/gtc/matrix_transform.hpp>
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "renderer/meshSimplifier.h"
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "renderer/rangeAllocator.h"
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "renderer/renderQueue.h"
+#include <algorithm>
+#include <random>
\ No newline at end of file
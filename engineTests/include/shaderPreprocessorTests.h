@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "rendering/shaderPreprocessor.h"
+#include <fstream>
\ No newline at end of file
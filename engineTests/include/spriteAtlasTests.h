@@ -0,0 +1,8 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "rendering/spriteAtlas.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "aabbTreeTests.h"
+
+namespace
+{
+	Engine::AABB box(const glm::vec3& centre, float halfSize)
+	{
+		Engine::AABB result;
+		result.min = centre - glm::vec3(halfSize);
+		result.max = centre + glm::vec3(halfSize);
+		return result;
+	}
+
+	std::vector<uint32_t> queryAll(const Engine::AABBTree& tree, const Engine::Frustum& frustum = Engine::Frustum())
+	{
+		std::vector<uint32_t> results;
+		Engine::AABBTreeQueryStats stats;
+		tree.query(frustum, results, stats);
+		std::sort(results.begin(), results.end());
+		return results;
+	}
+}
+
+TEST(AABBTree, Empty)
+{
+	Engine::AABBTree tree;
+
+	EXPECT_EQ(tree.getHeight(), 0);
+	EXPECT_TRUE(queryAll(tree).empty());
+}
+
+TEST(AABBTree, Insert)
+{
+	Engine::AABBTree tree(0.5f);
+	int32_t proxies[3];
+	for (uint32_t i = 0; i < 3; i++)
+		proxies[i] = tree.insert(box(glm::vec3(i * 10.0f, 0.0f, 0.0f), 1.0f), i + 100);
+
+	EXPECT_EQ(queryAll(tree), std::vector<uint32_t>({ 100, 101, 102 }));
+	EXPECT_EQ(tree.getUserData(proxies[1]), 101);
+
+	//leaves keep a box fattened by the margin.
+	const Engine::AABB& fat = tree.getFatBounds(proxies[1]);
+	EXPECT_FLOAT_EQ(fat.min.x, 8.5f);
+	EXPECT_FLOAT_EQ(fat.max.x, 11.5f);
+}
+
+TEST(AABBTree, StaysBalanced)
+{
+	//boxes in a row are the worst case for an unbalanced tree; this also grows the node array while leaves are linked in.
+	Engine::AABBTree tree;
+	for (uint32_t i = 0; i < 256; i++)
+		tree.insert(box(glm::vec3(i * 3.0f, 0.0f, 0.0f), 1.0f), i);
+
+	EXPECT_LE(tree.getHeight(), 16);
+	EXPECT_EQ(queryAll(tree).size(), 256);
+}
+
+TEST(AABBTree, Remove)
+{
+	Engine::AABBTree tree;
+	std::vector<int32_t> proxies;
+	for (uint32_t i = 0; i < 8; i++)
+		proxies.push_back(tree.insert(box(glm::vec3(i * 10.0f, 0.0f, 0.0f), 1.0f), i));
+
+	tree.remove(proxies[3]);
+	tree.remove(proxies[0]);
+	EXPECT_EQ(queryAll(tree), std::vector<uint32_t>({ 1, 2, 4, 5, 6, 7 }));
+
+	//freed nodes are reused.
+	int32_t proxy = tree.insert(box(glm::vec3(0.0f), 1.0f), 42);
+	EXPECT_LT(proxy, 15);
+	EXPECT_EQ(tree.getUserData(proxy), 42);
+
+	for (uint32_t i = 1; i < 8; i++)
+		if (i != 3) tree.remove(proxies[i]);
+	tree.remove(proxy);
+	EXPECT_TRUE(queryAll(tree).empty());
+	EXPECT_EQ(tree.getHeight(), 0);
+}
+
+TEST(AABBTree, UpdateWithinFatBox)
+{
+	Engine::AABBTree tree(1.0f);
+	int32_t proxy = tree.insert(box(glm::vec3(0.0f), 1.0f), 7);
+	tree.insert(box(glm::vec3(10.0f, 0.0f, 0.0f), 1.0f), 8);
+	Engine::AABB fat = tree.getFatBounds(proxy);
+
+	//a small move stays inside the fat box and leaves the tree alone.
+	EXPECT_FALSE(tree.update(proxy, box(glm::vec3(0.5f, 0.0f, 0.0f), 1.0f)));
+	EXPECT_EQ(tree.getFatBounds(proxy).min, fat.min);
+	EXPECT_EQ(tree.getFatBounds(proxy).max, fat.max);
+
+	//a bigger one reinserts it around the new box.
+	EXPECT_TRUE(tree.update(proxy, box(glm::vec3(5.0f, 0.0f, 0.0f), 1.0f)));
+	EXPECT_FLOAT_EQ(tree.getFatBounds(proxy).min.x, 3.0f);
+	EXPECT_FLOAT_EQ(tree.getFatBounds(proxy).max.x, 7.0f);
+	EXPECT_EQ(tree.getUserData(proxy), 7);
+	EXPECT_EQ(queryAll(tree), std::vector<uint32_t>({ 7, 8 }));
+}
+
+TEST(AABBTree, Query)
+{
+	//a grid of boxes along x and z, none straddling an edge; the frustum looks down -z and sees x between -10 and 10.
+	Engine::AABBTree tree;
+	uint32_t inside = 0;
+	for (int32_t x = -10; x < 10; x++)
+	{
+		for (int32_t z = 0; z < 10; z++)
+		{
+			glm::vec3 centre(x * 5.0f + 2.5f, 0.0f, -5.0f - z * 5.0f);
+			tree.insert(box(centre, 1.0f), (x + 10) * 10 + z);
+			if (centre.x > -10.0f && centre.x < 10.0f)
+				inside++;
+		}
+	}
+
+	Engine::Frustum frustum(glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 100.0f));
+	std::vector<uint32_t> results;
+	Engine::AABBTreeQueryStats stats;
+	tree.query(frustum, results, stats);
+
+	EXPECT_EQ(results.size(), inside);
+	EXPECT_EQ(stats.visible, inside);
+	for (uint32_t userData : results)
+	{
+		int32_t x = static_cast<int32_t>(userData / 10) - 10;
+		EXPECT_GT(x * 5.0f + 2.5f, -10.0f);
+		EXPECT_LT(x * 5.0f + 2.5f, 10.0f);
+	}
+
+	//whole branches are culled or taken without reaching every node.
+	EXPECT_LT(stats.nodesTested, 2 * 200 - 1);
+}
\ No newline at end of file
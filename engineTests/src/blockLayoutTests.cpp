@@ -0,0 +1,67 @@
+#include "blockLayoutTests.h"
+
+TEST(BlockLayout, Std140Vec3)
+{
+	//a vec3 starts on 16 bytes, but a scalar after it fills its last 4.
+	using Layout = Engine::BlockLayout<Engine::BlockRules::Std140, glm::vec3, float, glm::vec3>;
+
+	EXPECT_EQ(Layout::offset<0>, 0);
+	EXPECT_EQ(Layout::offset<1>, 12);
+	EXPECT_EQ(Layout::offset<2>, 16);
+	EXPECT_EQ(Layout::size, 32);
+}
+
+TEST(BlockLayout, Std140Arrays)
+{
+	//std140 pads every array element to a vec4, std430 doesn't.
+	using Std140 = Engine::BlockLayout<Engine::BlockRules::Std140, Engine::BlockArray<float, 4>, float>;
+	using Std430 = Engine::BlockLayout<Engine::BlockRules::Std430, Engine::BlockArray<float, 4>, float>;
+
+	EXPECT_EQ(Std140::offset<1>, 64);
+	EXPECT_EQ(Std430::offset<1>, 16);
+	EXPECT_EQ(Std430::size, 20);
+}
+
+TEST(BlockLayout, Structs)
+{
+	using Std140 = Engine::BlockLayout<Engine::BlockRules::Std140, float, Engine::BlockStruct<float>, float>;
+	using Std430 = Engine::BlockLayout<Engine::BlockRules::Std430, float, Engine::BlockStruct<float>, float>;
+
+	EXPECT_EQ(Std140::offset<1>, 16);
+	EXPECT_EQ(Std140::offset<2>, 32);
+	EXPECT_EQ(Std430::offset<1>, 4);
+	EXPECT_EQ(Std430::offset<2>, 8);
+}
+
+TEST(BlockLayout, Matrices)
+{
+	//a mat3 is three vec4 columns.
+	using Layout = Engine::BlockLayout<Engine::BlockRules::Std430, glm::mat4, glm::mat3, uint32_t>;
+
+	EXPECT_EQ(Layout::offset<1>, 64);
+	EXPECT_EQ(Layout::offset<2>, 112);
+	EXPECT_EQ(Layout::size, 128);
+}
+
+TEST(BlockLayout, UniformBufferLayoutMatches)
+{
+	//the runtime layout used to look fields up by name has to agree with the compile time one.
+	Engine::UniformBufferLayout runtime = {
+		{ "a", Engine::ShaderDataType::Float3 },
+		{ "b", Engine::ShaderDataType::Float },
+		{ "c", Engine::ShaderDataType::Mat3 },
+		{ "d", Engine::ShaderDataType::Int }
+	};
+	using Layout = Engine::BlockLayout<Engine::BlockRules::Std140, glm::vec3, float, glm::mat3, int32_t>;
+
+	std::vector<uint32_t> offsets;
+	for (const auto& element : runtime)
+		offsets.push_back(element.m_offset);
+
+	ASSERT_EQ(offsets.size(), 4);
+	EXPECT_EQ(offsets[0], Layout::offset<0>);
+	EXPECT_EQ(offsets[1], Layout::offset<1>);
+	EXPECT_EQ(offsets[2], Layout::offset<2>);
+	EXPECT_EQ(offsets[3], Layout::offset<3>);
+	EXPECT_EQ(runtime.getStride(), Layout::size);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "frustumTests.h"
+
+namespace
+{
+	Engine::AABB box(const glm::vec3& centre, float halfSize)
+	{
+		Engine::AABB result;
+		result.min = centre - glm::vec3(halfSize);
+		result.max = centre + glm::vec3(halfSize);
+		return result;
+	}
+
+	//looking down -z from the origin, 20 wide and high, from 1 to 100 deep.
+	Engine::Frustum orthoFrustum()
+	{
+		return Engine::Frustum(glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 100.0f));
+	}
+}
+
+TEST(Frustum, DefaultHasEverythingInside)
+{
+	Engine::Frustum frustum;
+
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f), 1.0f)), Engine::FrustumTest::Inside);
+	EXPECT_EQ(frustum.test(box(glm::vec3(1.0e6f, -1.0e6f, 1.0e6f), 100.0f)), Engine::FrustumTest::Inside);
+}
+
+TEST(Frustum, PlanesAreNormalised)
+{
+	Engine::Frustum frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f));
+
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		glm::vec4 plane = frustum.getPlane(i);
+		EXPECT_NEAR(glm::length(glm::vec3(plane)), 1.0f, 1.0e-5f);
+	}
+}
+
+TEST(Frustum, Classify)
+{
+	Engine::Frustum frustum = orthoFrustum();
+
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f, 0.0f, -50.0f), 1.0f)), Engine::FrustumTest::Inside);
+	EXPECT_EQ(frustum.test(box(glm::vec3(10.0f, 0.0f, -50.0f), 1.0f)), Engine::FrustumTest::Intersecting);
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f, 0.0f, -100.0f), 1.0f)), Engine::FrustumTest::Intersecting);
+	EXPECT_EQ(frustum.test(box(glm::vec3(20.0f, 0.0f, -50.0f), 1.0f)), Engine::FrustumTest::Outside);
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f, -20.0f, -50.0f), 1.0f)), Engine::FrustumTest::Outside);
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f)), Engine::FrustumTest::Outside);
+	EXPECT_EQ(frustum.test(box(glm::vec3(0.0f, 0.0f, -200.0f), 1.0f)), Engine::FrustumTest::Outside);
+}
+
+TEST(Frustum, ViewMovesPlanes)
+{
+	//the same box is outside until the camera moves over to it.
+	glm::mat4 projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 100.0f);
+	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-30.0f, 0.0f, 0.0f));
+	Engine::AABB target = box(glm::vec3(30.0f, 0.0f, -50.0f), 1.0f);
+
+	EXPECT_EQ(Engine::Frustum(projection).test(target), Engine::FrustumTest::Outside);
+	EXPECT_EQ(Engine::Frustum(projection * view).test(target), Engine::FrustumTest::Inside);
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "meshSimplifierTests.h"
+
+namespace
+{
+	const Engine::VertexBufferLayout layout = { Engine::ShaderDataType::Float3 };
+
+	//a flat square in the xy plane of size by size cells, two triangles a cell, wound to face +z.
+	void grid(uint32_t size, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+	{
+		for (uint32_t y = 0; y <= size; y++)
+			for (uint32_t x = 0; x <= size; x++)
+				positions.push_back({ static_cast<float>(x), static_cast<float>(y), 0.0f });
+
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				uint32_t corner = y * (size + 1) + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + size + 2 });
+				indices.insert(indices.end(), { corner, corner + size + 2, corner + size + 1 });
+			}
+		}
+	}
+
+	//twice the area each triangle covers facing +z, summed; folded triangles count against it.
+	float facingArea(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
+	{
+		float area = 0.0f;
+		for (uint32_t i = 0; i + 2 < indices.size(); i += 3)
+			area += glm::cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]]).z;
+		return area;
+	}
+
+	//no triangle left with a corner repeated or no area.
+	void expectNoDegenerates(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
+	{
+		ASSERT_EQ(indices.size() % 3, 0);
+		for (uint32_t i = 0; i < indices.size(); i += 3)
+		{
+			uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			EXPECT_TRUE(a != b && b != c && c != a) << "triangle " << i / 3;
+			EXPECT_GT(glm::length(glm::cross(positions[b] - positions[a], positions[c] - positions[a])), 0.0f) << "triangle " << i / 3;
+		}
+	}
+}
+
+TEST(MeshSimplifier, FlatGrid)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices, result;
+	grid(4, positions, indices);
+
+	float error = Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 1.0f, result);
+
+	//every collapse stays in the plane, and the border is locked so the square keeps its shape.
+	EXPECT_EQ(error, 0.0f);
+	EXPECT_LT(result.size(), indices.size());
+	expectNoDegenerates(positions, result);
+	EXPECT_FLOAT_EQ(facingArea(positions, result), facingArea(positions, indices));
+}
+
+TEST(MeshSimplifier, StopsAtTarget)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices, result;
+	grid(8, positions, indices);
+
+	uint32_t target = indices.size() / 2;
+	Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), target, 1.0f, result);
+	EXPECT_LE(result.size(), target);
+	EXPECT_GT(result.size(), 0);
+	expectNoDegenerates(positions, result);
+}
+
+TEST(MeshSimplifier, DegenerateInput)
+{
+	//a grid with a triangle repeating a corner and one with its corners in a line mixed in.
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices, result;
+	grid(4, positions, indices);
+	indices.insert(indices.end(), { 6, 6, 7 });
+	indices.insert(indices.end(), { 6, 7, 8 });
+
+	Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 1.0f, result);
+	EXPECT_LT(result.size(), indices.size());
+	expectNoDegenerates(positions, result);
+	for (uint32_t index : result)
+		EXPECT_LT(index, positions.size());
+}
+
+TEST(MeshSimplifier, RefusesFold)
+{
+	//every collapse on a tetrahedron would fold it flat onto itself.
+	std::vector<glm::vec3> positions = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	std::vector<uint32_t> indices = { 0, 2, 1, 0, 1, 3, 1, 2, 3, 0, 3, 2 }, result;
+
+	float error = Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 100.0f, result);
+	EXPECT_EQ(result, indices);
+	EXPECT_EQ(error, 0.0f);
+}
+
+TEST(MeshSimplifier, SeamsAndBordersLocked)
+{
+	//one triangle on its own; all three edges are border, so nothing can move.
+	std::vector<glm::vec3> positions = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+	std::vector<uint32_t> indices = { 0, 1, 2 }, result;
+
+	Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 100.0f, result);
+	EXPECT_EQ(result, indices);
+}
+
+TEST(MeshSimplifier, MaxError)
+{
+	//a grid with its middle vertex raised; flattening it would move the surface by more than allowed.
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices, result;
+	grid(2, positions, indices);
+	positions[4].z = 1.0f;
+
+	float error = Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 0.1f, result);
+	EXPECT_EQ(result, indices);
+	EXPECT_EQ(error, 0.0f);
+
+	error = Engine::MeshSimplifier::simplify(positions.data(), positions.size(), layout, indices.data(), indices.size(), 0, 10.0f, result);
+	EXPECT_LT(result.size(), indices.size());
+	EXPECT_GT(error, 0.0f);
+	EXPECT_LE(error, 10.0f);
+	expectNoDegenerates(positions, result);
+}
+
+TEST(MeshSimplifier, NeedsPositionFirst)
+{
+	std::vector<float> vertices(12);
+	std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 }, result;
+	Engine::VertexBufferLayout uvs = { Engine::ShaderDataType::Float2, Engine::ShaderDataType::Float2 };
+
+	float error = Engine::MeshSimplifier::simplify(vertices.data(), 3, uvs, indices.data(), indices.size(), 0, 1.0f, result);
+	EXPECT_EQ(result, indices);
+	EXPECT_EQ(error, 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "rangeAllocatorTests.h"
+
+namespace
+{
+	using Runs = std::vector<std::pair<uint32_t, uint32_t>>;
+
+	//the free runs as (start, count) pairs, for comparing in one go.
+	Runs runs(const Engine::RangeAllocator& allocator)
+	{
+		Runs result;
+		for (auto& range : allocator.getFreeRanges())
+			result.push_back({ range.start, range.count });
+		return result;
+	}
+}
+
+TEST(RangeAllocator, AllocatesInOrder)
+{
+	Engine::RangeAllocator allocator(100);
+	uint32_t a, b;
+	ASSERT_TRUE(allocator.allocate(10, a));
+	ASSERT_TRUE(allocator.allocate(20, b));
+	EXPECT_EQ(a, 0);
+	EXPECT_EQ(b, 10);
+	EXPECT_EQ(allocator.getFreeCount(), 70);
+	EXPECT_EQ(runs(allocator), Runs({ { 30, 70 } }));
+}
+
+TEST(RangeAllocator, FirstFit)
+{
+	Engine::RangeAllocator allocator(100);
+	uint32_t a, b, c, d, e;
+	allocator.allocate(10, a);
+	allocator.allocate(10, b);
+	allocator.allocate(30, c);
+	allocator.allocate(10, d);
+	allocator.release(a, 10);
+	allocator.release(c, 30);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 10 }, { 20, 30 }, { 60, 40 } }));
+
+	//too big for the first hole, so it goes in the second even though the last run is a closer fit.
+	ASSERT_TRUE(allocator.allocate(25, e));
+	EXPECT_EQ(e, 20);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 10 }, { 45, 5 }, { 60, 40 } }));
+
+	//an exact fit uses the hole up.
+	ASSERT_TRUE(allocator.allocate(10, e));
+	EXPECT_EQ(e, 0);
+	EXPECT_EQ(runs(allocator), Runs({ { 45, 5 }, { 60, 40 } }));
+}
+
+TEST(RangeAllocator, Full)
+{
+	Engine::RangeAllocator allocator(50);
+	uint32_t a, b;
+	ASSERT_TRUE(allocator.allocate(50, a));
+	EXPECT_TRUE(allocator.getFreeRanges().empty());
+	EXPECT_FALSE(allocator.allocate(1, b));
+
+	//enough free in total but not in one run.
+	allocator.release(0, 10);
+	allocator.release(20, 10);
+	EXPECT_EQ(allocator.getFreeCount(), 20);
+	EXPECT_FALSE(allocator.allocate(15, b));
+	EXPECT_EQ(allocator.getFreeCount(), 20);
+}
+
+TEST(RangeAllocator, MergesWithPrevious)
+{
+	Engine::RangeAllocator allocator(30);
+	uint32_t a, b, c;
+	allocator.allocate(10, a);
+	allocator.allocate(10, b);
+	allocator.allocate(10, c);
+	allocator.release(a, 10);
+	allocator.release(b, 10);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 20 } }));
+}
+
+TEST(RangeAllocator, MergesWithNext)
+{
+	Engine::RangeAllocator allocator(30);
+	uint32_t a, b, c;
+	allocator.allocate(10, a);
+	allocator.allocate(10, b);
+	allocator.allocate(10, c);
+	allocator.release(c, 10);
+	allocator.release(b, 10);
+	EXPECT_EQ(runs(allocator), Runs({ { 10, 20 } }));
+}
+
+TEST(RangeAllocator, MergesWithBoth)
+{
+	Engine::RangeAllocator allocator(100);
+	uint32_t a, b, c;
+	allocator.allocate(10, a);
+	allocator.allocate(10, b);
+	allocator.allocate(10, c);
+	allocator.release(a, 10);
+	allocator.release(c, 10);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 10 }, { 20, 80 } }));
+
+	allocator.release(b, 10);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 100 } }));
+	EXPECT_EQ(allocator.getFreeCount(), 100);
+}
+
+TEST(RangeAllocator, KeepsRunsApart)
+{
+	//given back between two runs in use, it stays on its own and in order.
+	Engine::RangeAllocator allocator(50);
+	uint32_t starts[5];
+	for (uint32_t i = 0; i < 5; i++)
+		allocator.allocate(10, starts[i]);
+	allocator.release(starts[3], 10);
+	allocator.release(starts[1], 10);
+	EXPECT_EQ(runs(allocator), Runs({ { 10, 10 }, { 30, 10 } }));
+}
+
+TEST(RangeAllocator, ReleaseAllLeavesOneRun)
+{
+	Engine::RangeAllocator allocator(64);
+	uint32_t starts[8];
+	for (uint32_t i = 0; i < 8; i++)
+		allocator.allocate(8, starts[i]);
+
+	for (uint32_t i : { 5, 1, 7, 3, 0, 6, 2, 4 })
+		allocator.release(starts[i], 8);
+	EXPECT_EQ(runs(allocator), Runs({ { 0, 64 } }));
+	EXPECT_EQ(allocator.getFreeCount(), 64);
+}
\ No newline at end of file
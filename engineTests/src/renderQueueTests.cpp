@@ -0,0 +1,65 @@
+#include "renderQueueTests.h"
+
+TEST(RenderQueue, SortsKeys)
+{
+	Engine::RenderQueue queue;
+	std::vector<uint64_t> keys = { 0xFF00000000000000, 3, 0x100, 0, 0x8000000000000001, 0xFFFFFFFFFFFFFFFF, 0x10000 };
+	for (uint32_t i = 0; i < keys.size(); i++)
+		queue.push(keys[i], i);
+	queue.sort();
+
+	std::sort(keys.begin(), keys.end());
+	ASSERT_EQ(queue.getCount(), keys.size());
+	for (uint32_t i = 0; i < keys.size(); i++)
+		EXPECT_EQ(queue.getEntries()[i].key, keys[i]);
+}
+
+TEST(RenderQueue, EqualKeys)
+{
+	//every byte the same, so every pass is skipped and the order is left alone.
+	Engine::RenderQueue queue;
+	for (uint32_t i = 0; i < 100; i++)
+		queue.push(0x0123456789ABCDEF, i);
+	queue.sort();
+
+	for (uint32_t i = 0; i < 100; i++)
+		EXPECT_EQ(queue.getEntries()[i].index, i);
+}
+
+TEST(RenderQueue, Stable)
+{
+	//few distinct keys spread over high and low bytes; entries with the same key keep the order they were pushed in.
+	const uint64_t distinct[] = { 0, 1, 0x100000000, 0x100000001, 0xFF00000000000000 };
+	std::mt19937 random(7);
+	Engine::RenderQueue queue;
+	std::vector<Engine::RenderQueueEntry> expected;
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		uint64_t key = distinct[random() % 5];
+		queue.push(key, i);
+		expected.push_back({ key, i });
+	}
+	queue.sort();
+
+	std::stable_sort(expected.begin(), expected.end(), [](const Engine::RenderQueueEntry& a, const Engine::RenderQueueEntry& b) { return a.key < b.key; });
+	for (uint32_t i = 0; i < expected.size(); i++)
+	{
+		EXPECT_EQ(queue.getEntries()[i].key, expected[i].key);
+		EXPECT_EQ(queue.getEntries()[i].index, expected[i].index);
+	}
+}
+
+TEST(RenderQueue, ClearKeepsWorking)
+{
+	Engine::RenderQueue queue;
+	queue.push(2, 0);
+	queue.push(1, 1);
+	queue.sort();
+	queue.clear();
+	EXPECT_EQ(queue.getCount(), 0);
+
+	queue.push(5, 0);
+	queue.sort();
+	ASSERT_EQ(queue.getCount(), 1);
+	EXPECT_EQ(queue.getEntries()[0].index, 0);
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "shaderPreprocessorTests.h"
+
+namespace
+{
+	//a file in the test's temporary directory; returns its path.
+	std::string write(const std::string& name, const std::string& text)
+	{
+		std::string path = testing::TempDir() + name;
+		std::ofstream(path) << text;
+		return path;
+	}
+}
+
+TEST(ShaderPreprocessor, NoIncludes)
+{
+	std::string path = write("plain.glsl", "#version 440 core\nvoid main() {}\n");
+	std::string source;
+	ASSERT_TRUE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+	EXPECT_EQ(source, "#version 440 core\nvoid main() {}\n");
+}
+
+TEST(ShaderPreprocessor, Includes)
+{
+	write("common.glsl", "float common() { return 1.0; }\n");
+	std::string path = write("includes.glsl", "#version 440 core\n  #include \"common.glsl\"\nvoid main() {}\n");
+	std::string source;
+	ASSERT_TRUE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+	EXPECT_EQ(source, "#version 440 core\nfloat common() { return 1.0; }\nvoid main() {}\n");
+}
+
+TEST(ShaderPreprocessor, IncludeTwiceUnguarded)
+{
+	//not a cycle; the same file side by side goes in both times.
+	write("twice.glsl", "x\n");
+	std::string path = write("twiceMain.glsl", "#include \"twice.glsl\"\n#include \"twice.glsl\"\n");
+	std::string source;
+	ASSERT_TRUE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+	EXPECT_EQ(source, "x\nx\n");
+}
+
+TEST(ShaderPreprocessor, IncludesItself)
+{
+	std::string path = write("self.glsl", "#include \"self.glsl\"\n");
+	std::string source;
+	EXPECT_FALSE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+}
+
+TEST(ShaderPreprocessor, IncludeCycle)
+{
+	write("cycleB.glsl", "b\n#include \"cycleC.glsl\"\n");
+	write("cycleC.glsl", "c\n#include \"cycleB.glsl\"\n");
+	std::string path = write("cycleA.glsl", "a\n#include \"cycleB.glsl\"\n");
+	std::string source;
+	EXPECT_FALSE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+}
+
+TEST(ShaderPreprocessor, IncludeDepth)
+{
+	//a chain of files each including the next; as deep as allowed loads, one deeper doesn't.
+	const uint32_t depth = Engine::ShaderPreprocessor::maxIncludeDepth;
+	for (uint32_t i = 0; i < depth; i++)
+		write("depth" + std::to_string(i) + ".glsl", "#include \"depth" + std::to_string(i + 1) + ".glsl\"\n");
+	write("depth" + std::to_string(depth) + ".glsl", "bottom\n");
+
+	std::string source;
+	std::string path = testing::TempDir() + "depth1.glsl";
+	ASSERT_TRUE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+	EXPECT_EQ(source, "bottom\n");
+
+	path = testing::TempDir() + "depth0.glsl";
+	EXPECT_FALSE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+}
+
+TEST(ShaderPreprocessor, MissingInclude)
+{
+	std::string path = write("missing.glsl", "#include \"notThere.glsl\"\n");
+	std::string source;
+	EXPECT_FALSE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+
+	path = write("unquoted.glsl", "#include <common.glsl>\n");
+	EXPECT_FALSE(Engine::ShaderPreprocessor::load(path.c_str(), source));
+}
+
+TEST(ShaderPreprocessor, AddDefines)
+{
+	std::string source = "#region Vertex\n#version 440 core\nvoid main() {}\n#region Fragment\n#version 440 core\nvoid main() {}\n";
+	std::string result = Engine::ShaderPreprocessor::addDefines(source, { "SKINNED", "LIGHTS 4" });
+	EXPECT_EQ(result, "#region Vertex\n#version 440 core\n#define SKINNED\n#define LIGHTS 4\nvoid main() {}\n"
+		"#region Fragment\n#version 440 core\n#define SKINNED\n#define LIGHTS 4\nvoid main() {}\n");
+
+	EXPECT_EQ(Engine::ShaderPreprocessor::addDefines(source, {}), source);
+}
+
+TEST(ShaderPreprocessor, AddDefinesIndentedVersion)
+{
+	std::string result = Engine::ShaderPreprocessor::addDefines(" \t#version 440 core\nvoid main() {}\n", { "SHADOWS" });
+	EXPECT_EQ(result, " \t#version 440 core\n#define SHADOWS\nvoid main() {}\n");
+
+	//mentioning #version anywhere but the start of a line isn't one.
+	result = Engine::ShaderPreprocessor::addDefines("#version 440 core\n// #version\n", { "SHADOWS" });
+	EXPECT_EQ(result, "#version 440 core\n#define SHADOWS\n// #version\n");
+}
\ No newline at end of file
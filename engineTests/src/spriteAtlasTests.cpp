@@ -0,0 +1,173 @@
+#include "spriteAtlasTests.h"
+
+namespace
+{
+	struct PackedSprite
+	{
+		std::string name;
+		uint32_t page;
+		int32_t x, y, width, height;
+	};
+
+	//a binary PPM, so the test needs nothing to write images with; it loads as opaque RGBA.
+	std::string writeImage(const std::string& name, int32_t width, int32_t height)
+	{
+		std::string filepath = testing::TempDir() + name + ".ppm";
+		std::ofstream file(filepath, std::ios::binary);
+		file << "P6\n" << width << " " << height << "\n255\n";
+		std::vector<char> pixels(width * height * 3, static_cast<char>(200));
+		file.write(pixels.data(), pixels.size());
+		return filepath;
+	}
+
+	//pack count square images of one size, and read back where they went from the written atlas.
+	std::vector<PackedSprite> pack(const Engine::SpriteAtlasSettings& settings, uint32_t count, int32_t size, bool& built, uint32_t& pages)
+	{
+		Engine::SpriteAtlasBuilder builder(settings);
+		for (uint32_t i = 0; i < count; i++)
+			builder.addImage("sprite" + std::to_string(i), writeImage("sprite" + std::to_string(size) + "_" + std::to_string(i), size, size));
+
+		built = builder.build();
+		pages = builder.getPageCount();
+		EXPECT_TRUE(builder.write(testing::TempDir(), "spriteAtlasTest"));
+
+		std::vector<PackedSprite> sprites;
+		std::ifstream atlas(testing::TempDir() + "/spriteAtlasTest.atlas");
+		std::string line;
+		while (std::getline(atlas, line))
+		{
+			std::stringstream stream(line);
+			std::string type;
+			PackedSprite sprite;
+			stream >> type;
+			if (type == "sprite" && stream >> sprite.name >> sprite.page >> sprite.x >> sprite.y >> sprite.width >> sprite.height)
+				sprites.push_back(sprite);
+		}
+		return sprites;
+	}
+
+	void expectNoOverlaps(const std::vector<PackedSprite>& sprites, int32_t pageSize)
+	{
+		for (uint32_t i = 0; i < sprites.size(); i++)
+		{
+			const PackedSprite& a = sprites[i];
+			EXPECT_GE(a.x, 0);
+			EXPECT_GE(a.y, 0);
+			EXPECT_LE(a.x + a.width, pageSize);
+			EXPECT_LE(a.y + a.height, pageSize);
+
+			for (uint32_t j = i + 1; j < sprites.size(); j++)
+			{
+				const PackedSprite& b = sprites[j];
+				bool overlaps = a.page == b.page && a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+				EXPECT_FALSE(overlaps) << a.name << " overlaps " << b.name;
+			}
+		}
+	}
+}
+
+TEST(SpriteAtlas, FillsPageExactly)
+{
+	//sixteen 16x16 images tile a 64x64 page with nothing left over.
+	Engine::SpriteAtlasSettings settings;
+	settings.pageSize = 64;
+	settings.padding = 0;
+
+	bool built;
+	uint32_t pages;
+	std::vector<PackedSprite> sprites = pack(settings, 16, 16, built, pages);
+
+	EXPECT_TRUE(built);
+	EXPECT_EQ(pages, 1);
+	ASSERT_EQ(sprites.size(), 16);
+	expectNoOverlaps(sprites, 64);
+}
+
+TEST(SpriteAtlas, FullPageStartsAnother)
+{
+	Engine::SpriteAtlasSettings settings;
+	settings.pageSize = 64;
+	settings.padding = 0;
+
+	bool built;
+	uint32_t pages;
+	std::vector<PackedSprite> sprites = pack(settings, 17, 16, built, pages);
+
+	EXPECT_TRUE(built);
+	EXPECT_EQ(pages, 2);
+	ASSERT_EQ(sprites.size(), 17);
+	uint32_t onFirstPage = 0;
+	for (const auto& sprite : sprites)
+		onFirstPage += sprite.page == 0;
+	EXPECT_EQ(onFirstPage, 16);
+	expectNoOverlaps(sprites, 64);
+}
+
+TEST(SpriteAtlas, PaddingCountsTowardsFit)
+{
+	//16x16 with 2 pixels of padding takes 18x18, so only three fit across a 64 page.
+	Engine::SpriteAtlasSettings settings;
+	settings.pageSize = 64;
+	settings.padding = 2;
+
+	bool built;
+	uint32_t pages;
+	std::vector<PackedSprite> sprites = pack(settings, 10, 16, built, pages);
+
+	EXPECT_TRUE(built);
+	EXPECT_EQ(pages, 2);
+	ASSERT_EQ(sprites.size(), 10);
+	for (uint32_t i = 0; i < sprites.size(); i++)
+	{
+		for (uint32_t j = i + 1; j < sprites.size(); j++)
+		{
+			const PackedSprite& a = sprites[i];
+			const PackedSprite& b = sprites[j];
+			if (a.page == b.page)
+				EXPECT_TRUE(a.x + 18 <= b.x || b.x + 18 <= a.x || a.y + 18 <= b.y || b.y + 18 <= a.y) << a.name << " is within the padding of " << b.name;
+		}
+	}
+}
+
+TEST(SpriteAtlas, TooBigForPage)
+{
+	Engine::SpriteAtlasSettings settings;
+	settings.pageSize = 64;
+	settings.padding = 0;
+
+	Engine::SpriteAtlasBuilder builder(settings);
+	builder.addImage("big", writeImage("big", 65, 65));
+	builder.addImage("small", writeImage("small", 8, 8));
+
+	//the one that fits is still packed.
+	EXPECT_FALSE(builder.build());
+	EXPECT_EQ(builder.getPageCount(), 1);
+}
+
+TEST(SpriteAtlas, NamesWithWhitespaceRejected)
+{
+	//a space in a name would shift every field after it on the sprite's line in the .atlas file.
+	Engine::SpriteAtlasSettings settings;
+	settings.pageSize = 64;
+	Engine::SpriteAtlasBuilder builder(settings);
+	std::string filepath = writeImage("spaced", 8, 8);
+	builder.addImage("two words", filepath);
+	builder.addImage("tab\tbed", filepath);
+	builder.addImage("", filepath);
+	builder.addImage("kept", filepath);
+
+	EXPECT_TRUE(builder.build());
+	EXPECT_TRUE(builder.write(testing::TempDir(), "spacedAtlasTest"));
+
+	std::ifstream atlas(testing::TempDir() + "/spacedAtlasTest.atlas");
+	std::vector<std::string> names;
+	std::string line;
+	while (std::getline(atlas, line))
+	{
+		std::stringstream stream(line);
+		std::string type, name;
+		if (stream >> type >> name && type == "sprite")
+			names.push_back(name);
+	}
+	EXPECT_EQ(names, std::vector<std::string>({ "kept" }));
+}
\ No newline at end of file
@@ -154,6 +154,7 @@ project "Sandbox"
 		location "engineTests"
         kind "ConsoleApp"
         language "C++"
+		cppdialect "C++17"
 		staticruntime "off"
 		systemversion "latest"
 
@@ -191,7 +192,8 @@ project "Sandbox"
 
         links 
 		{ 
-			"googletest"
+			"googletest",
+			"Engine"
 		}
 		
 		filter "configurations:Debug"
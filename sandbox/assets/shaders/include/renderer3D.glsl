@@ -0,0 +1,33 @@
+//the storage blocks Renderer3D fills; included by every stage that reads them.
+#ifndef RENDERER3D_GLSL
+#define RENDERER3D_GLSL
+
+//per instance data written by Renderer3D; the draw's base instance is where its instances start.
+//the MVP and normal matrix are worked out once per instance on the CPU, not per vertex.
+struct DrawData
+{
+	mat4 model;
+	mat4 mvp;
+	mat3 normalMatrix;
+	uint material;
+};
+
+layout (std430, binding = 0) readonly buffer b_draws
+{
+	DrawData u_draws[];
+};
+
+//every material's parameters, baked by Renderer3D and only uploaded when one changes.
+struct MaterialParameters
+{
+	vec4 tint;
+	uint flags;
+};
+
+layout (std140, binding = 1) readonly buffer b_materials
+{
+	MaterialParameters u_materials[];
+};
+
+#endif
+
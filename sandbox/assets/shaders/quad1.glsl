@@ -3,17 +3,22 @@
 
 layout(location = 0) in vec2 a_vertexPosition;
 layout(location = 1) in vec2 a_texCoords;
+layout(location = 2) in int a_texUnit;
+layout(location = 3) in vec4 a_tint;
 
 out vec2 textCoords;
+flat out int texUnit;
+out vec4 tint;
 
-uniform mat4 u_model;
 uniform mat4 u_view;
 uniform mat4 u_projection;
 
 void main()
 {
 	textCoords = vec2(a_texCoords);
-	gl_Position = u_projection * u_view * u_model * vec4(a_vertexPosition, 1.0, 1.0);
+	texUnit = a_texUnit;
+	tint = a_tint;
+	gl_Position = u_projection * u_view * vec4(a_vertexPosition, 1.0, 1.0);
 }
 
 #region Fragment
@@ -21,11 +26,52 @@ void main()
 
 layout(location = 0) out vec4 colour;
 in vec2 textCoords;
+flat in int texUnit;
+in vec4 tint;
 
-uniform vec4 u_tint;
-uniform sampler2D u_texData;
+uniform sampler2D u_texData[16];
+
+const int flag_SDF = 1 << 8;
+
+//the unit differs between quads in one draw, so it can't index the sampler array; each unit gets its own texture call instead. The derivatives
+//are taken before the switch, implicit ones aren't defined once neighbouring pixels take different cases.
+vec4 sampleUnit(int unit, vec2 uv)
+{
+	vec2 dx = dFdx(uv);
+	vec2 dy = dFdy(uv);
+	switch (unit)
+	{
+		case 0: return textureGrad(u_texData[0], uv, dx, dy);
+		case 1: return textureGrad(u_texData[1], uv, dx, dy);
+		case 2: return textureGrad(u_texData[2], uv, dx, dy);
+		case 3: return textureGrad(u_texData[3], uv, dx, dy);
+		case 4: return textureGrad(u_texData[4], uv, dx, dy);
+		case 5: return textureGrad(u_texData[5], uv, dx, dy);
+		case 6: return textureGrad(u_texData[6], uv, dx, dy);
+		case 7: return textureGrad(u_texData[7], uv, dx, dy);
+		case 8: return textureGrad(u_texData[8], uv, dx, dy);
+		case 9: return textureGrad(u_texData[9], uv, dx, dy);
+		case 10: return textureGrad(u_texData[10], uv, dx, dy);
+		case 11: return textureGrad(u_texData[11], uv, dx, dy);
+		case 12: return textureGrad(u_texData[12], uv, dx, dy);
+		case 13: return textureGrad(u_texData[13], uv, dx, dy);
+		case 14: return textureGrad(u_texData[14], uv, dx, dy);
+		case 15: return textureGrad(u_texData[15], uv, dx, dy);
+	}
+	return vec4(1.0);
+}
 
 void main()
 {
-	colour = texture(u_texData, textCoords) * u_tint;
+	//the low byte is the unit, anything above it is flags.
+	vec4 texel = sampleUnit(texUnit & 0xFF, textCoords);
+
+	//distance field; 0.5 is the edge, blend across about a screen pixel whatever size the glyph is drawn at.
+	if ((texUnit & flag_SDF) != 0)
+	{
+		float edgeWidth = fwidth(texel.a) * 0.5;
+		texel.a = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, texel.a);
+	}
+
+	colour = texel * tint;
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#region Vertex
+#version 440 core
+
+//the prototypical unit quad.
+layout(location = 0) in vec2 a_vertexPosition;
+layout(location = 1) in vec2 a_texCoords;
+
+//per instance.
+layout(location = 2) in vec2 a_translate;
+layout(location = 3) in vec2 a_scale;
+layout(location = 4) in vec4 a_UVRect;
+layout(location = 5) in float a_angle;
+layout(location = 6) in float a_texUnit;
+layout(location = 7) in vec4 a_tint;
+
+out vec2 textCoords;
+flat out int texUnit;
+out vec4 tint;
+
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+const float pi = 3.14159265;
+
+void main()
+{
+	//scale, rotate then translate the unit quad; same as the CPU batch does.
+	float angle = a_angle * pi;
+	float c = cos(angle);
+	float s = sin(angle);
+	vec2 scaled = a_vertexPosition * a_scale;
+	vec2 position = a_translate + vec2(c * scaled.x - s * scaled.y, s * scaled.x + c * scaled.y);
+
+	textCoords = mix(a_UVRect.xy, a_UVRect.zw, a_texCoords);
+	texUnit = int(a_texUnit + 0.5);
+	tint = a_tint;
+	gl_Position = u_projection * u_view * vec4(position, 1.0, 1.0);
+}
+
+#region Fragment
+#version 440 core
+
+layout(location = 0) out vec4 colour;
+in vec2 textCoords;
+flat in int texUnit;
+in vec4 tint;
+
+uniform sampler2D u_texData[16];
+
+const int flag_SDF = 1 << 8;
+
+//the unit differs between quads in one draw, so it can't index the sampler array; each unit gets its own texture call instead. The derivatives
+//are taken before the switch, implicit ones aren't defined once neighbouring pixels take different cases.
+vec4 sampleUnit(int unit, vec2 uv)
+{
+	vec2 dx = dFdx(uv);
+	vec2 dy = dFdy(uv);
+	switch (unit)
+	{
+		case 0: return textureGrad(u_texData[0], uv, dx, dy);
+		case 1: return textureGrad(u_texData[1], uv, dx, dy);
+		case 2: return textureGrad(u_texData[2], uv, dx, dy);
+		case 3: return textureGrad(u_texData[3], uv, dx, dy);
+		case 4: return textureGrad(u_texData[4], uv, dx, dy);
+		case 5: return textureGrad(u_texData[5], uv, dx, dy);
+		case 6: return textureGrad(u_texData[6], uv, dx, dy);
+		case 7: return textureGrad(u_texData[7], uv, dx, dy);
+		case 8: return textureGrad(u_texData[8], uv, dx, dy);
+		case 9: return textureGrad(u_texData[9], uv, dx, dy);
+		case 10: return textureGrad(u_texData[10], uv, dx, dy);
+		case 11: return textureGrad(u_texData[11], uv, dx, dy);
+		case 12: return textureGrad(u_texData[12], uv, dx, dy);
+		case 13: return textureGrad(u_texData[13], uv, dx, dy);
+		case 14: return textureGrad(u_texData[14], uv, dx, dy);
+		case 15: return textureGrad(u_texData[15], uv, dx, dy);
+	}
+	return vec4(1.0);
+}
+
+void main()
+{
+	//the low byte is the unit, anything above it is flags.
+	vec4 texel = sampleUnit(texUnit & 0xFF, textCoords);
+
+	//distance field; 0.5 is the edge, blend across about a screen pixel whatever size the glyph is drawn at.
+	if ((texUnit & flag_SDF) != 0)
+	{
+		float edgeWidth = fwidth(texel.a) * 0.5;
+		texel.a = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, texel.a);
+	}
+
+	colour = texel * tint;
+}
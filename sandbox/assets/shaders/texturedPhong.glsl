@@ -1,5 +1,6 @@
 #region Vertex
 #version 440 core
+#extension GL_ARB_shader_draw_parameters : require
 
 layout(location = 0) in vec3 a_vertexPosition;
 layout(location = 1) in vec3 a_vertexNormal;
@@ -7,20 +8,18 @@ layout(location = 2) in vec2 a_texCoord;
 out vec3 fragmentPos;
 out vec3 normal;
 out vec2 texCoord;
+flat out uint materialIndex;
 
-layout (std140) uniform b_camera
-{
-	mat4 u_projection;
-	mat4 u_view;
-};
-uniform mat4 u_model;
+#include "include/renderer3D.glsl"
 
 void main()
 {
-	fragmentPos = vec3(u_model * vec4(a_vertexPosition, 1.0));
-	normal = mat3(transpose(inverse(u_model))) * a_vertexNormal;
+	DrawData draw = u_draws[gl_BaseInstanceARB + gl_InstanceID];
+	fragmentPos = vec3(draw.model * vec4(a_vertexPosition, 1.0));
+	normal = draw.normalMatrix * a_vertexNormal;
 	texCoord = vec2(a_texCoord.x, a_texCoord.y);
-	gl_Position =  u_projection * u_view * u_model * vec4(a_vertexPosition,1.0);
+	materialIndex = draw.material;
+	gl_Position = draw.mvp * vec4(a_vertexPosition,1.0);
 }
 
 
@@ -31,6 +30,7 @@ layout(location = 0) out vec4 colour;
 in vec3 normal;
 in vec3 fragmentPos;
 in vec2 texCoord;
+flat in uint materialIndex;
 
 layout (std140) uniform b_lights
 {
@@ -39,7 +39,7 @@ layout (std140) uniform b_lights
 	vec3 u_lightColour;
 };
 
-uniform vec4 u_tint;
+#include "include/renderer3D.glsl"
 
 uniform sampler2D u_texData;
 
@@ -57,7 +57,15 @@ void main()
 	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
 	vec3 specular = specularStrength * spec * u_lightColour;  
 	
-	colour = vec4((ambient + diffuse + specular), 1.0) * texture(u_texData, texCoord) * u_tint;
+	colour = vec4((ambient + diffuse + specular), 1.0);
+
+	//each material flag combination is its own variant, so only what the material uses is here at all.
+#if defined(MATERIAL_DIFFUSE_TEXTURE) || defined(MATERIAL_DEFAULT_TEXTURE)
+	colour *= texture(u_texData, texCoord);
+#endif
+#ifdef MATERIAL_TINT
+	colour *= u_materials[materialIndex].tint;
+#endif
 	
 	//BELOW FOR DEBUGGING TO VISUAL NORMAL AND UV DATA
 	//colour = vec4(normal, 1.0);
@@ -0,0 +1,32 @@
+#region Vertex
+#version 440 core
+
+layout(location = 0) in vec2 a_texCoords;
+layout(location = 1) in vec2 a_corner;
+
+out vec2 textCoords;
+
+uniform mat4 u_view;
+uniform mat4 u_projection;
+uniform vec2 u_chunkOrigin;
+uniform float u_tileSize;
+
+void main()
+{
+	//corners are whole tiles from the chunk origin.
+	textCoords = a_texCoords;
+	gl_Position = u_projection * u_view * vec4(u_chunkOrigin + a_corner * u_tileSize, 1.0, 1.0);
+}
+
+#region Fragment
+#version 440 core
+
+layout(location = 0) out vec4 colour;
+in vec2 textCoords;
+
+uniform sampler2D u_tileset;
+
+void main()
+{
+	colour = texture(u_tileset, textCoords);
+}